@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Generates src/gamma_table.h, the lookup tables that map the
+#              upper 8 bits of a filtered ADC value to a PWM duty cycle,
+#              one for the TIM2 PWM (See src/pwm.c) and one of 8-bit duty
+#              cycles for the software PWM (See src/soft_pwm.c). The eye perceives brightness roughly as
+#              duty^(1/gamma), so the table raises the linear pot position
+#              to the power of custom_pwm_gamma to make the brightness
+#              follow the pot evenly. custom_pwm_top sets the TIM2
+#              auto-reload value and with it the PWM resolution.
+#
+#              Runs as a pre: extra script of the firmware environment, and
+#              can be run by hand to regenerate or check the table, the
+#              same way as spl/spl_conf.py.
+#
+# Usage:       gamma.py [--check]
+
+import configparser
+import inspect
+import os
+import sys
+
+PROJECT_DIR = os.path.dirname(os.path.abspath(inspect.getframeinfo(inspect.currentframe()).filename)) # No __file__ under SCons
+
+STEPS = 256		# One entry per value of the upper 8 ADC bits
+DEFAULT_GAMMA = "2.2"
+DEFAULT_TOP = "1023"
+
+class GammaError(Exception):
+	pass
+
+def parse_options(gamma, top):
+	try:
+		gamma = float(gamma)
+		top = int(top, 0)
+	except ValueError:
+		raise GammaError("custom_pwm_gamma must be a number and custom_pwm_top an integer")
+
+	if not 1.0 <= gamma <= 4.0:
+		raise GammaError("custom_pwm_gamma must be between 1.0 and 4.0, got %g" % gamma)
+	if not STEPS - 1 <= top <= 0xFFFE:
+		raise GammaError("custom_pwm_top must be between %d and 65534, got %d" % (STEPS - 1, top))
+
+	return gamma, top
+
+def curve(gamma, full):
+	return [int(full * (i / (STEPS - 1)) ** gamma + 0.5) for i in range(STEPS)]
+
+def rows(table, width):
+	return ["\t" + ", ".join("%*d" % (width, v) for v in table[i:i + 8]) + "," for i in range(0, STEPS, 8)]
+
+def render(gamma, top):
+	# PWM mode 1 keeps the output high while the counter is below the
+	# compare value, so top + 1 is 100% duty. The software PWM is on for
+	# duty out of 255 units, so 255 is.
+	lines = ["// Generated by gamma.py from custom_pwm_gamma and custom_pwm_top in platformio.ini, do not edit.",
+		 "// Included by pwm.c and main.c, each only gets the table of its LED_MODE",
+		 "",
+		 "#define GAMMA_STEPS %d" % STEPS,
+		 "#define GAMMA_TOP   %d // TIM2 auto-reload value" % top,
+		 "",
+		 "#if LED_MODE == LED_MODE_SOFT_PWM",
+		 "",
+		 "// duty = round(255 * (i / %d)^%g)" % (STEPS - 1, gamma),
+		 "static const uint8_t gamma_table_8[GAMMA_STEPS] = {"]
+	lines += rows(curve(gamma, 255), 3)
+	lines += ["};",
+		  "",
+		  "#else",
+		  "",
+		  "// duty = round((GAMMA_TOP + 1) * (i / %d)^%g)" % (STEPS - 1, gamma),
+		  "static const uint16_t gamma_table[GAMMA_STEPS] = {"]
+	lines += rows(curve(gamma, top + 1), 5)
+	lines += ["};",
+		  "",
+		  "#endif"]
+
+	return "\n".join(lines) + "\n"
+
+def write_table(src_dir, gamma, top, check=False):
+	"""Writes src_dir/gamma_table.h if its content changed. Returns True if
+	   the file was (or, with check set, would have been) changed."""
+	path = os.path.join(src_dir, "gamma_table.h")
+	table = render(gamma, top)
+
+	try:
+		with open(path, newline="") as f:
+			if f.read() == table:
+				return False
+	except FileNotFoundError:
+		pass
+
+	if not check:
+		with open(path, "w", newline="") as f:
+			f.write(table)
+
+	return True
+
+def project_options():
+	"""Returns (gamma, top) of the first environment that runs this script"""
+	ini = configparser.ConfigParser(inline_comment_prefixes=(";",))
+	ini.read(os.path.join(PROJECT_DIR, "platformio.ini"))
+
+	for section in ini.sections():
+		if "gamma.py" in ini.get(section, "extra_scripts", fallback=""):
+			return parse_options(ini.get(section, "custom_pwm_gamma", fallback=DEFAULT_GAMMA),
+					     ini.get(section, "custom_pwm_top", fallback=DEFAULT_TOP))
+
+	return parse_options(DEFAULT_GAMMA, DEFAULT_TOP)
+
+def main():
+	import argparse
+
+	parser = argparse.ArgumentParser(description="Generate src/gamma_table.h of adc_led_threshold")
+	parser.add_argument("--check", action="store_true", help="Only report an out of date table, exit with 1 if so")
+	args = parser.parse_args()
+
+	try:
+		gamma, top = project_options()
+	except GammaError as e:
+		sys.exit("error: %s" % e)
+
+	if write_table(os.path.join(PROJECT_DIR, "src"), gamma, top, args.check):
+		print("gamma_table.h: %s" % ("out of date" if args.check else "updated"))
+		return 1 if args.check else 0
+
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main())
+elif "Import" in globals(): # PlatformIO extra script
+	Import("env")
+
+	try:
+		gamma, top = parse_options(env.GetProjectOption("custom_pwm_gamma", DEFAULT_GAMMA),
+					   env.GetProjectOption("custom_pwm_top", DEFAULT_TOP))
+		write_table(env.subst("$PROJECT_SRC_DIR"), gamma, top)
+	except GammaError as e:
+		sys.stderr.write("Error: %s\n" % e)
+		env.Exit(1)
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: ADC1 analog watchdog threshold detection
+ * 		The ADC converts continuously in the background and only
+ * 		interrupts the CPU once the signal leaves the programmed
+ * 		threshold window.
+ */
+
+#ifndef _ADC_AWD_H_INCLUDED_
+#define _ADC_AWD_H_INCLUDED_
+
+#include <stm8s.h>
+
+// ADC clock prescaler, the watchdog checks every conversion
+#ifndef ADC_AWD_PRESSEL
+#define ADC_AWD_PRESSEL ADC1_PRESSEL_FCPU_D18
+#endif
+
+void adc_awd_init(ADC1_Channel_TypeDef channel, ADC1_SchmittTrigg_TypeDef schmitt_channel);
+void adc_awd_start(void);
+
+bool adc_awd_event(void); // Returns TRUE once per threshold crossing
+bool adc_awd_above(void); // TRUE if the signal last crossed THRESHOLD_HIGH
+
+// Called from ADC1_IRQHandler (See stm8s_it.c)
+void adc_awd_isr(void);
+
+#endif /* _ADC_AWD_H_INCLUDED_ */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Interrupt driven ADC1 sampler
+ * 		Conversions are started in continuous mode and each EOC
+ * 		(End-Of-Conversion) interrupt pushes the result into a
+ * 		single-producer/single-consumer ring buffer, which is
+ * 		drained by the main loop.
+ */
+
+#ifndef _ADC_SAMPLER_H_INCLUDED_
+#define _ADC_SAMPLER_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Number of samples the ring can hold. Must be a power of two and not
+// larger than 128, since the free-running 8-bit indices are masked with
+// ADC_RING_SIZE - 1 and their difference must fit into a uint8_t.
+#ifndef ADC_RING_SIZE
+#define ADC_RING_SIZE 8
+#endif
+
+#if (ADC_RING_SIZE & (ADC_RING_SIZE - 1)) != 0 || ADC_RING_SIZE > 128
+#error ADC_RING_SIZE must be a power of two no larger than 128!
+#endif
+
+// ADC clock prescaler. One conversion takes 14 ADC clock cycles, so at
+// fCPU = 2MHz and fCPU/18 we get 2MHz/18/14 = ~7.9k samples/s, leaving
+// ~250 CPU cycles between two EOC interrupts. If ADC_SAMPLE_RATE_HZ is set
+// (See config.h), the prescaler only sets the conversion time, which must
+// be shorter than the sample period.
+#ifndef ADC_SAMPLER_PRESSEL
+#define ADC_SAMPLER_PRESSEL ADC1_PRESSEL_FCPU_D18
+#endif
+
+void adc_sampler_init(ADC1_Channel_TypeDef channel, ADC1_SchmittTrigg_TypeDef schmitt_channel);
+void adc_sampler_start(void);
+void adc_sampler_stop(void);
+
+bool adc_sampler_available(void);
+uint16_t adc_sampler_read(void);
+uint16_t adc_sampler_overruns(void);
+
+// Recalibrate the TIM1 sample trigger on a clock switch, only if
+// ADC_SAMPLE_RATE_HZ is set (See clock_users.c)
+bool adc_sampler_clock_prepare(uint32_t hz);
+void adc_sampler_clock_apply(uint32_t hz);
+
+// Called from ADC1_IRQHandler (see stm8s_it.c)
+void adc_sampler_isr(void);
+
+#endif /* _ADC_SAMPLER_H_INCLUDED_ */
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Buffered multi-channel ADC1 scan
+ * 		Converts channels 0..N in a single hardware sweep and hands
+ * 		out a pointer to the ADC1 data buffer registers, so results
+ * 		are read in place rather than copied.
+ */
+
+#ifndef _ADC_SCAN_H_INCLUDED_
+#define _ADC_SCAN_H_INCLUDED_
+
+#include <stm8s.h>
+
+// ADC clock prescaler used for the sweep
+#ifndef ADC_SCAN_PRESSEL
+#define ADC_SCAN_PRESSEL ADC1_PRESSEL_FCPU_D2
+#endif
+
+void adc_scan_init(ADC1_Channel_TypeDef last_channel);
+void adc_scan_start(void);
+bool adc_scan_ready(void);
+
+// Returns a pointer to the 10-bit results, indexed by channel number.
+// The results remain valid until adc_scan_release() is called.
+const volatile uint16_t *adc_scan_results(void);
+void adc_scan_release(void);
+
+// Called from ADC1_IRQHandler (See stm8s_it.c)
+void adc_scan_isr(void);
+
+#endif /* _ADC_SCAN_H_INCLUDED_ */
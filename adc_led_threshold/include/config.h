@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Build time configuration for the adc_led_threshold example
+ * 		Every option can be overridden through the build_flags
+ * 		option in platformio.ini, ex. -D ADC_MODE=ADC_MODE_SCAN
+ */
+
+#ifndef _CONFIG_H_INCLUDED_
+#define _CONFIG_H_INCLUDED_
+
+#define MAX_ADC_VAL 1023 // Max value of 10 Bit ADC
+
+// ADC acquisition modes
+#define ADC_MODE_SINGLE 0 // Single channel, interrupt driven sampler (See adc_sampler.c)
+#define ADC_MODE_SCAN   1 // Buffered multi-channel scan (See adc_scan.c)
+#define ADC_MODE_AWD    2 // Hardware threshold detection by the analog watchdog (See adc_awd.c)
+
+#ifndef ADC_MODE
+#define ADC_MODE ADC_MODE_SINGLE
+#endif
+
+// Sample rate of ADC_MODE_SINGLE in Hz. If set to 0, the ADC converts
+// back-to-back at a rate given by its prescaler (See adc_sampler.h).
+// Otherwise, TIM1 triggers every conversion at exactly this rate.
+#ifndef ADC_SAMPLE_RATE_HZ
+#define ADC_SAMPLE_RATE_HZ 0
+#endif
+
+// Digital filter applied to every sample (See filter.c)
+#define FILTER_NONE       0 // Raw samples
+#define FILTER_MOVING_AVG 1 // Moving average over 2^FILTER_SHIFT samples
+#define FILTER_IIR        2 // Single-pole IIR, y += (x - y) / 2^FILTER_SHIFT
+
+#ifndef FILTER_TYPE
+#define FILTER_TYPE FILTER_IIR
+#endif
+
+// Window size (moving average) or smoothing factor (IIR) as a power of two.
+// Limited to 6, as the 10-bit samples are accumulated in 16 bits.
+#ifndef FILTER_SHIFT
+#define FILTER_SHIFT 3
+#endif
+
+// Define FILTER_PROFILE to record the cycles spent per sample on filtering
+// and comparison in filter_cycles/filter_cycles_max (See main.c).
+// Uses TIM2 as a free-running cycle counter.
+
+// Set TELEMETRY to 1 to stream every filtered sample over UART1 at UART_BAUD
+// (See uart.h), in binary frames (See telemetry.h). Frames that do not fit
+// into the TX ring are dropped, so the sampling never waits for the line.
+// Not available in ADC_MODE_AWD.
+#ifndef TELEMETRY
+#define TELEMETRY 0
+#endif
+
+#if TELEMETRY && ADC_MODE == ADC_MODE_AWD
+#error TELEMETRY requires ADC_MODE_SINGLE or ADC_MODE_SCAN!
+#endif
+
+// The telemetry frames are binary and nothing reads from the UART, so with
+// XON/XOFF flow control (See uart.h) a single 0x13 from the host would stop
+// the stream for good, and stray host input would make the driver insert
+// XOFF into a frame. Flow control is therefore off with TELEMETRY.
+#if TELEMETRY
+#ifndef UART_FLOW_XONXOFF
+#define UART_FLOW_XONXOFF 0
+#elif UART_FLOW_XONXOFF
+#error UART_FLOW_XONXOFF cannot be used with TELEMETRY, which sends binary frames and never reads the UART!
+#endif
+#endif
+
+// Blocks of the static RAM pool (See pool.h). Telemetry packs each frame
+// into a block, and a second one lets a complete frame wait for room in
+// the UART TX ring while the next is packed (See telemetry.c).
+#ifndef POOL_BLOCKS
+#define POOL_BLOCKS (TELEMETRY ? 2 : 0)
+#endif
+
+// Define CLOCK_SOURCE to switch the clock once sampling has started, ex.
+// -D CLOCK_SOURCE=CLOCK_HSI for 16MHz (See clock.h). The ADC prescaler, the
+// TIM1 sample trigger and the UART baud rate follow the switch (See
+// clock_users.c). Everything is set up at F_CPU first, which must match
+// the reset clock of 2MHz. If a module cannot run at the new clock, the
+// example stays at F_CPU.
+
+// How the filtered value is shown
+#define LED_MODE_THRESHOLD 0 // Built-in LED on above THRESHOLD_HIGH, off below THRESHOLD_LOW
+#define LED_MODE_PWM       1 // LED on PD4 (TIM2_CH1) dimmed by hardware PWM (See pwm.c)
+#define LED_MODE_SOFT_PWM  2 // Built-in LED dimmed by software PWM on TIM4 (See soft_pwm.c)
+
+#ifndef LED_MODE
+#define LED_MODE LED_MODE_THRESHOLD
+#endif
+
+#if LED_MODE == LED_MODE_PWM && ADC_MODE == ADC_MODE_AWD
+#error LED_MODE_PWM requires ADC_MODE_SINGLE or ADC_MODE_SCAN!
+#endif
+
+#if LED_MODE == LED_MODE_SOFT_PWM && ADC_MODE == ADC_MODE_AWD
+#error LED_MODE_SOFT_PWM requires ADC_MODE_SINGLE or ADC_MODE_SCAN!
+#endif
+
+#if LED_MODE == LED_MODE_PWM && (defined(FILTER_PROFILE) || defined(SPURIOUS_SELFTEST))
+#error LED_MODE_PWM uses TIM2 itself!
+#endif
+
+// Hysteresis band of the threshold comparator. The LED turns on once the
+// filtered value rises above THRESHOLD_HIGH and only turns off again once
+// it falls below THRESHOLD_LOW.
+#ifndef THRESHOLD_LOW
+#define THRESHOLD_LOW  (MAX_ADC_VAL/2 - 16)
+#endif
+
+#ifndef THRESHOLD_HIGH
+#define THRESHOLD_HIGH (MAX_ADC_VAL/2 + 16)
+#endif
+
+#endif /* _CONFIG_H_INCLUDED_ */
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Fixed-point ADC filter and hysteresis comparator
+ */
+
+#ifndef _FILTER_H_INCLUDED_
+#define _FILTER_H_INCLUDED_
+
+#include <stm8s.h>
+#include <config.h>
+
+#if FILTER_SHIFT < 1 || FILTER_SHIFT > 6
+#error FILTER_SHIFT must be within 1..6!
+#endif
+
+#if THRESHOLD_LOW > THRESHOLD_HIGH
+#error THRESHOLD_LOW must not be above THRESHOLD_HIGH!
+#endif
+
+void filter_reset(uint16_t initial);
+uint16_t filter_update(uint16_t sample);
+
+void hysteresis_reset(bool state);
+bool hysteresis_update(uint16_t val); // Returns TRUE if the output state has changed
+bool hysteresis_state(void);
+
+#endif /* _FILTER_H_INCLUDED_ */
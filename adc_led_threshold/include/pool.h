@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Static pool of fixed-size RAM blocks
+ * 		For buffers that are only needed for a while, ex. a
+ * 		telemetry frame from its first sample until the UART has
+ * 		room for it. Blocks are taken off and put back onto a free
+ * 		list in constant time, and since every block has the same
+ * 		size, the pool never fragments. Its size is fixed at build
+ * 		time, so it shows up in the map file and in the RAM report
+ * 		(See ram/ in the repository root) like any other global.
+ *
+ * 		Not interrupt safe, only call from the main loop.
+ */
+
+#ifndef _POOL_H_INCLUDED_
+#define _POOL_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Bytes per block, must hold the largest buffer taken from the pool
+#ifndef POOL_BLOCK_SIZE
+#define POOL_BLOCK_SIZE 48
+#endif
+
+// Number of blocks, set per example in config.h. 0 leaves the pool out.
+#ifndef POOL_BLOCKS
+#error POOL_BLOCKS not defined
+#endif
+
+#if POOL_BLOCK_SIZE < 2 || POOL_BLOCKS > 255
+#error POOL_BLOCK_SIZE must be at least 2 and POOL_BLOCKS at most 255!
+#endif
+
+void pool_init(void);
+
+// Returns a block of POOL_BLOCK_SIZE bytes, or NULL if all are in use
+void *pool_alloc(void);
+
+// Returns a block to the pool. NULL is ignored.
+void pool_free(void *block);
+
+// Blocks not in use
+uint8_t pool_available(void);
+
+#endif /* _POOL_H_INCLUDED_ */
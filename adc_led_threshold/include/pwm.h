@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: LED dimming by hardware PWM
+ * 		TIM2 drives channel 1 (PD4) in PWM mode 1. The duty cycle is
+ * 		looked up from the upper 8 bits of the filtered ADC value in
+ * 		a gamma corrected table, which gamma.py generates at build
+ * 		time (See src/gamma_table.h). Between two updates, the
+ * 		brightness is kept by the timer alone.
+ *
+ * Pin Out:	PWM : PD4 (TIM2_CH1), LED and series resistor to GND
+ */
+
+#ifndef _PWM_H_INCLUDED_
+#define _PWM_H_INCLUDED_
+
+#include <stm8s.h>
+
+void pwm_init(void);
+
+// Sets the duty cycle for a 10-bit value. A table read and two register
+// writes, short enough to be called from ADC1_IRQHandler.
+void pwm_update(uint16_t adc_val);
+
+#endif /* _PWM_H_INCLUDED_ */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Software PWM for pins without a timer channel
+ * 		Drives up to 8 GPIOs, ex. the built-in LED on PB5, at 8-bit
+ * 		resolution from the TIM4 update interrupt. The channels are
+ * 		bit-angle modulated: a frame consists of 8 slots, slot k
+ * 		lasts 2^k time units and outputs bit k of every duty cycle.
+ * 		That takes 8 interrupts per frame, independent of the number
+ * 		of channels and their duty cycles. The handler writes one
+ * 		precomputed byte per GPIO port, so its cost grows with the
+ * 		number of ports the channels are spread over, not with the
+ * 		number of channels (See soft_pwm.c).
+ *
+ * Pin Out:	Channel 0 : PB5 (Built-in LED), channels 1 to 7 : See soft_pwm.c
+ */
+
+#ifndef _SOFT_PWM_H_INCLUDED_
+#define _SOFT_PWM_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Number of channels, 1 to 8
+#ifndef SOFT_PWM_CHANNELS
+#define SOFT_PWM_CHANNELS 1
+#endif
+
+// Frame rate in Hz. TIM4 can stretch a frame to 255 * 256 CPU cycles at
+// most, so above ~6.5MHz the frame rate rises beyond this value instead.
+#ifndef SOFT_PWM_HZ
+#define SOFT_PWM_HZ 100
+#endif
+
+// Sets all channels to 0 and starts TIM4
+void soft_pwm_init(void);
+
+// TRUE once the last committed duty cycles are being output, so a new set
+// can be committed. Goes FALSE on soft_pwm_commit() until the next frame.
+bool soft_pwm_ready(void);
+
+// Sets the duty cycle of a channel, from 0 (off) to 255 (on). Only takes
+// effect once committed.
+void soft_pwm_set(uint8_t channel, uint8_t duty);
+
+// Computes the slot patterns of all channels and hands them to the
+// interrupt handler, which switches to them at the start of the next
+// frame, so a frame never mixes old and new duty cycles. Returns FALSE
+// without doing anything if the previous commit has not been taken yet.
+bool soft_pwm_commit(void);
+
+// Recalibrates the time unit after a clock switch (See clock_users.c).
+// Refuses clocks too slow for SOFT_PWM_HZ (See soft_pwm.c).
+bool soft_pwm_clock_prepare(uint32_t hz);
+void soft_pwm_clock_apply(uint32_t hz);
+
+// Called by TIM4_UPD_OVF_IRQHandler
+void soft_pwm_isr(void);
+
+#endif /* _SOFT_PWM_H_INCLUDED_ */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Binary telemetry framing for streaming ADC samples
+ * 		Samples are packed 4 per 5 bytes, protected by a CRC-8 and
+ * 		framed with COBS, so a receiver can resynchronize on any
+ * 		0x00 byte. See tools/telemetry_decode.py for the host side.
+ *
+ * Frame (before COBS encoding):
+ * 		+-----+-------------------------------+-----+
+ * 		| seq | TELEMETRY_SAMPLES packed 10b  | crc |
+ * 		+-----+-------------------------------+-----+
+ * 		  1B     TELEMETRY_SAMPLES * 5/4 B      1B
+ *
+ * 		seq counts up by one per frame, so the receiver can tell
+ * 		how many frames were lost. crc is the CRC-8 (polynomial
+ * 		0x07, initial value 0x00) of seq and the packed samples.
+ * 		Every group of 4 samples s0..s3 is packed as:
+ * 		s0[7:0] s1[7:0] s2[7:0] s3[7:0] s3[9:8]s2[9:8]s1[9:8]s0[9:8]
+ */
+
+#ifndef _TELEMETRY_H_INCLUDED_
+#define _TELEMETRY_H_INCLUDED_
+
+#include <stm8s.h>
+#include <uart.h>
+#include <pool.h>
+
+// Samples per frame. Must be a multiple of 4. More samples per frame
+// lower the relative overhead of seq, crc and the COBS bytes, but the
+// whole encoded frame must fit into the UART TX ring.
+#ifndef TELEMETRY_SAMPLES
+#define TELEMETRY_SAMPLES 32
+#endif
+
+#define TELEMETRY_PACKED_LEN	(TELEMETRY_SAMPLES / 4 * 5)
+#define TELEMETRY_FRAME_LEN	(1 + TELEMETRY_PACKED_LEN + 1)	// seq + samples + crc
+#define TELEMETRY_ENCODED_LEN	(TELEMETRY_FRAME_LEN + 2)	// + COBS code byte + 0x00 delimiter
+
+#if TELEMETRY_SAMPLES % 4 != 0 || TELEMETRY_SAMPLES < 4
+#error TELEMETRY_SAMPLES must be a non-zero multiple of 4!
+#endif
+
+#if TELEMETRY_ENCODED_LEN > UART_TX_SIZE
+#error Encoded telemetry frame does not fit into UART_TX_SIZE!
+#endif
+
+#if TELEMETRY_FRAME_LEN > POOL_BLOCK_SIZE
+#error Telemetry frame does not fit into POOL_BLOCK_SIZE!
+#endif
+
+void telemetry_init(void);	// Takes a block of the pool, call after pool_init()
+void telemetry_push(uint16_t sample);
+uint16_t telemetry_dropped(void);
+
+#endif /* _TELEMETRY_H_INCLUDED_ */
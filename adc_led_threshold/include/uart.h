@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Interrupt driven UART1 driver
+ * 		Both directions are backed by ring buffers, so uart_write()
+ * 		and uart_read() never wait for the line. Bytes are moved
+ * 		between the rings and the data register by the TXE and
+ * 		RXNE interrupts.
+ *
+ * Pin Out:	TX : PD5
+ * 		RX : PD6
+ */
+
+#ifndef _UART_H_INCLUDED_
+#define _UART_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Baud rate. The divider is computed from F_CPU at compile time, so the
+// baud rate error depends on the clock. At 2MHz, 115200 baud is off by
+// 2.1%, at 16MHz rates up to 1Mbaud are possible. After a clock switch
+// (See clock.h), it is recomputed for the new clock, which is refused if
+// the baud rate cannot be generated from it.
+#ifndef UART_BAUD
+#define UART_BAUD 115200UL
+#endif
+
+// Ring sizes in bytes. Must be powers of two and not larger than 128,
+// for the same reason as ADC_RING_SIZE (See adc_sampler.h).
+#ifndef UART_TX_SIZE
+#define UART_TX_SIZE 64
+#endif
+
+#ifndef UART_RX_SIZE
+#define UART_RX_SIZE 16
+#endif
+
+#if (UART_TX_SIZE & (UART_TX_SIZE - 1)) != 0 || UART_TX_SIZE > 128
+#error UART_TX_SIZE must be a power of two no larger than 128!
+#endif
+
+#if (UART_RX_SIZE & (UART_RX_SIZE - 1)) != 0 || UART_RX_SIZE > 128
+#error UART_RX_SIZE must be a power of two no larger than 128!
+#endif
+
+// Software (XON/XOFF) flow control, UART1 has no RTS/CTS lines.
+// If set, a received XOFF pauses transmission until XON is received,
+// and XOFF is sent once the RX ring is filled up to UART_RX_SIZE minus
+// UART_RX_HEADROOM bytes, followed by XON once it has drained to half.
+// The headroom absorbs bytes the peer sends before it reacts to XOFF.
+#ifndef UART_FLOW_XONXOFF
+#define UART_FLOW_XONXOFF 1
+#endif
+
+#ifndef UART_RX_HEADROOM
+#define UART_RX_HEADROOM 4
+#endif
+
+#define UART_XON  0x11
+#define UART_XOFF 0x13
+
+void uart_init(void);
+
+uint8_t uart_write(const uint8_t *buf, uint8_t len);
+bool uart_putc(uint8_t c);
+uint8_t uart_tx_free(void);
+
+uint8_t uart_read(uint8_t *buf, uint8_t len);
+uint8_t uart_available(void);
+uint16_t uart_rx_overruns(void);
+
+// Recalibrate the baud rate on a clock switch (See clock_users.c)
+bool uart_clock_prepare(uint32_t hz);
+void uart_clock_apply(uint32_t hz);
+
+// Called from UART1_TX_IRQHandler and UART1_RX_IRQHandler (see stm8s_it.c)
+void uart_tx_isr(void);
+void uart_rx_isr(void);
+
+#endif /* _UART_H_INCLUDED_ */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the ADC1 analog watchdog threshold
+ * 		detection
+ *
+ * The analog watchdog sets the AWD flag whenever a conversion result lies
+ * outside of the window between the low (ADC_LTR) and high (ADC_HTR)
+ * threshold registers (See section 24.5.8 of the STM8S reference manual).
+ * Rather than using a fixed window, the window is moved after every
+ * crossing, which gives us the same hysteresis as the software comparator:
+ *
+ *  - Below:  Window is [0, THRESHOLD_HIGH], fires once the signal rises above
+ *  - Above:  Window is [THRESHOLD_LOW, MAX_ADC_VAL], fires once it falls below
+ */
+
+#include <config.h>
+#include <adc_awd.h>
+
+// Only built in ADC_MODE_AWD (See config.h)
+#if ADC_MODE == ADC_MODE_AWD
+
+static volatile bool _above;
+static volatile bool _event;
+
+static void set_window(bool above)
+{
+	if (above) {
+		ADC1_SetLowThreshold(THRESHOLD_LOW);
+		ADC1_SetHighThreshold(MAX_ADC_VAL);
+	} else {
+		ADC1_SetLowThreshold(0);
+		ADC1_SetHighThreshold(THRESHOLD_HIGH);
+	}
+}
+
+void adc_awd_init(ADC1_Channel_TypeDef channel, ADC1_SchmittTrigg_TypeDef schmitt_channel)
+{
+	ADC1_Init(
+		ADC1_CONVERSIONMODE_CONTINUOUS,	// Continuous conversion mode, every result is checked by the watchdog
+		channel,			// Channel to convert
+		ADC_AWD_PRESSEL,		// Prescaler
+		ADC1_EXTTRIG_GPIO,		// External trigger: GPIO (Irrelevant, as we're disabling the trigger)
+		DISABLE,			// Disable triggers
+		ADC1_ALIGN_RIGHT,		// ADC data alignment: Right
+		schmitt_channel,		// Selects schmitt trigger for the channel
+		DISABLE				// Disable schmitt trigger (See section 11.7.3, Table 23 of the reference manual)
+	);
+
+	_above = FALSE;
+	_event = FALSE;
+	set_window(FALSE);
+
+	ADC1_AWDChannelConfig(channel, ENABLE);	// Watch the converted channel
+	ADC1_ITConfig(ADC1_IT_AWDIE, ENABLE);	// Raise ADC1_IRQHandler on a threshold crossing, EOC stays silent
+}
+
+void adc_awd_start(void)
+{
+	ADC1_Cmd(ENABLE);	// Wake ADC1 up from power down
+	ADC1_StartConversion();	// Start continuous conversions
+}
+
+bool adc_awd_event(void)
+{
+	if (!_event)
+		return FALSE;
+
+	_event = FALSE;
+	return TRUE;
+}
+
+bool adc_awd_above(void)
+{
+	return _above;
+}
+
+void adc_awd_isr(void)
+{
+	_above = !_above;
+	set_window(_above);
+
+	ADC1->CSR &= (uint8_t)(~ADC1_CSR_AWD); // Clear AWD flag only after the window has moved
+	_event = TRUE;
+}
+
+#endif /* ADC_MODE == ADC_MODE_AWD */
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the interrupt driven ADC1 sampler
+ *
+ * The ring buffer is lock-free: the ISR is the only writer of _head and
+ * the main loop is the only writer of _tail. Both indices are single bytes,
+ * which the STM8 reads and writes atomically, so neither side ever has to
+ * disable interrupts. The indices run freely and are only masked when
+ * accessing the buffer, so (head - tail) is always the fill level.
+ *
+ * If ADC_SAMPLE_RATE_HZ is set, the ADC no longer converts back-to-back.
+ * Instead, TIM1 is set up to overflow at the sample rate and its update
+ * event is routed to TRGO, which ADC1 uses as its external trigger
+ * (ADC1_EXTTRIG_TIM). Each trigger starts a single conversion in hardware,
+ * so the sample instants do not depend on interrupt or main loop latency.
+ */
+
+#include <config.h>
+#include <adc_sampler.h>
+
+// Only built for the matching acquisition mode, SDCC does not drop unused functions
+#if ADC_MODE == ADC_MODE_SINGLE
+
+#define ADC_RING_MASK (ADC_RING_SIZE - 1)
+
+#if ADC_SAMPLE_RATE_HZ
+// Smallest TIM1 prescaler that lets the sample period fit into the 16-bit
+// auto-reload register, and the resulting auto-reload value
+#define TIM1_DIV ((F_CPU / (ADC_SAMPLE_RATE_HZ * 65536UL)) + 1)
+#define TIM1_ARR ((F_CPU / (TIM1_DIV * ADC_SAMPLE_RATE_HZ)) - 1)
+
+#if TIM1_ARR < 1
+#error ADC_SAMPLE_RATE_HZ is too high for F_CPU!
+#endif
+#endif
+
+static uint16_t _ring[ADC_RING_SIZE];
+static volatile uint8_t _head;		// Written by ISR only
+static volatile uint8_t _tail;		// Written by main loop only
+static volatile uint16_t _overruns;	// Samples dropped due to a full ring
+
+void adc_sampler_init(ADC1_Channel_TypeDef channel, ADC1_SchmittTrigg_TypeDef schmitt_channel)
+{
+#if ADC_SAMPLE_RATE_HZ
+	ADC1_Init(
+		ADC1_CONVERSIONMODE_SINGLE,	// One conversion per trigger
+		channel,			// Channel to convert
+		ADC_SAMPLER_PRESSEL,		// Prescaler, conversion must finish within one sample period
+		ADC1_EXTTRIG_TIM,		// External trigger: TIM1 TRGO
+		ENABLE,				// Enable trigger
+		ADC1_ALIGN_RIGHT,		// ADC data alignment: Right
+		schmitt_channel,		// Selects schmitt trigger for the channel
+		DISABLE				// Disable schmitt trigger (See section 11.7.3, Table 23 of the reference manual)
+	);
+
+	TIM1_DeInit();
+	TIM1_TimeBaseInit(
+		TIM1_DIV - 1,			// Prescaler: fCPU/TIM1_DIV
+		TIM1_COUNTERMODE_UP,		// Count up to TIM1_ARR, then overflow
+		TIM1_ARR,			// Auto-reload value, sets the sample period
+		0				// No repetition
+	);
+	TIM1_SelectOutputTrigger(TIM1_TRGOSOURCE_UPDATE); // Drive TRGO with the update event
+#else
+	ADC1_Init(
+		ADC1_CONVERSIONMODE_CONTINUOUS,	// Continuous conversion mode, every conversion raises EOC
+		channel,			// Channel to convert
+		ADC_SAMPLER_PRESSEL,		// Prescaler, determines the sample rate (See adc_sampler.h)
+		ADC1_EXTTRIG_GPIO,		// External trigger: GPIO (Irrelevant, as we're disabling the trigger)
+		DISABLE,			// Disable triggers
+		ADC1_ALIGN_RIGHT,		// ADC data alignment: Right
+		schmitt_channel,		// Selects schmitt trigger for the channel
+		DISABLE				// Disable schmitt trigger (See section 11.7.3, Table 23 of the reference manual)
+	);
+#endif
+
+	ADC1_ITConfig(ADC1_IT_EOCIE, ENABLE); // Raise ADC1_IRQHandler on End-Of-Conversion
+
+	_head = 0;
+	_tail = 0;
+	_overruns = 0;
+}
+
+void adc_sampler_start(void)
+{
+	ADC1_Cmd(ENABLE);	// Wake ADC1 up from power down
+#if ADC_SAMPLE_RATE_HZ
+	TIM1_Cmd(ENABLE);	// Conversions are now started by TIM1 TRGO
+#else
+	ADC1_StartConversion();	// Start continuous conversions
+#endif
+}
+
+void adc_sampler_stop(void)
+{
+#if ADC_SAMPLE_RATE_HZ
+	TIM1_Cmd(DISABLE);
+#endif
+	ADC1_Cmd(DISABLE);
+}
+
+bool adc_sampler_available(void)
+{
+	return _head != _tail;
+}
+
+// Must only be called if adc_sampler_available() returned TRUE
+uint16_t adc_sampler_read(void)
+{
+	uint16_t val = _ring[_tail & ADC_RING_MASK];
+	_tail++; // Single byte write, hands the slot back to the ISR
+	return val;
+}
+
+uint16_t adc_sampler_overruns(void)
+{
+	uint16_t ret;
+
+	// 16-bit counter is written by the ISR, read it twice to avoid a torn value
+	do {
+		ret = _overruns;
+	} while (ret != _overruns);
+
+	return ret;
+}
+
+#if ADC_SAMPLE_RATE_HZ
+// The same prescaler and auto-reload value as TIM1_DIV and TIM1_ARR,
+// computed for the clock the CPU has just switched to
+bool adc_sampler_clock_prepare(uint32_t hz)
+{
+	return hz / ADC_SAMPLE_RATE_HZ >= 2; // Auto-reload value of at least 1
+}
+
+void adc_sampler_clock_apply(uint32_t hz)
+{
+	uint16_t div = (uint16_t)(hz / (ADC_SAMPLE_RATE_HZ * 65536UL)) + 1;
+	uint16_t arr = (uint16_t)(hz / ((uint32_t)div * ADC_SAMPLE_RATE_HZ)) - 1;
+
+	// High bytes first, writing the low byte updates the register
+	TIM1->PSCRH = (uint8_t)((div - 1) >> 8);
+	TIM1->PSCRL = (uint8_t)(div - 1);
+	TIM1->ARRH = (uint8_t)(arr >> 8);
+	TIM1->ARRL = (uint8_t)arr;
+	TIM1->EGR = TIM1_EGR_UG; // Load the prescaler now rather than at the next overflow, also triggers a conversion
+}
+#endif
+
+void adc_sampler_isr(void)
+{
+	uint8_t lsb, msb;
+
+	// Right alignment: LSB must be read before the MSB
+	// (See section 24.8 of the STM8S reference manual)
+	lsb = ADC1->DRL;
+	msb = ADC1->DRH;
+	ADC1->CSR &= (uint8_t)(~ADC1_CSR_EOC); // Clear EOC flag
+
+	if ((uint8_t)(_head - _tail) == ADC_RING_SIZE) {
+		_overruns++; // Main loop fell behind, drop the sample
+		return;
+	}
+
+	_ring[_head & ADC_RING_MASK] = ((uint16_t)msb << 8) | lsb;
+	_head++; // Publish the sample only after it has been written
+}
+
+#endif /* ADC_MODE == ADC_MODE_SINGLE */
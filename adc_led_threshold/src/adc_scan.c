@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the buffered multi-channel ADC1 scan
+ *
+ * In single scan mode, ADC1 converts every channel from 0 up to the
+ * selected channel and stores each result in its own data buffer register
+ * pair (ADC_DBxRH/ADC_DBxRL), raising EOC only once the whole sweep is
+ * done (See section 24.5.6 of the STM8S reference manual). The ADC then
+ * stays idle until the next sweep is started, so the buffer registers can
+ * safely be read in place. Since the STM8 is big-endian and the data is
+ * right aligned, each register pair reads as a plain uint16_t.
+ */
+
+#include <config.h>
+#include <adc_scan.h>
+
+// Only built in ADC_MODE_SCAN (See config.h)
+#if ADC_MODE == ADC_MODE_SCAN
+
+static volatile bool _ready;
+
+void adc_scan_init(ADC1_Channel_TypeDef last_channel)
+{
+	uint16_t scanned = (uint16_t)((2UL << last_channel) - 1); // Bit n set for channel n of the sweep
+
+	ADC1_Init(
+		ADC1_CONVERSIONMODE_SINGLE,	// One sweep per start, results stay put until the next one
+		last_channel,			// Sweep covers channels 0..last_channel
+		ADC_SCAN_PRESSEL,		// Prescaler
+		ADC1_EXTTRIG_GPIO,		// External trigger: GPIO (Irrelevant, as we're disabling the trigger)
+		DISABLE,			// Disable triggers
+		ADC1_ALIGN_RIGHT,		// ADC data alignment: Right, so DBxRH:DBxRL reads as a 10-bit value
+		ADC1_SCHMITTTRIG_CHANNEL0,	// Selects schmitt trigger of the first channel, the others follow below
+		DISABLE				// Disable schmitt trigger (See section 11.7.3, Table 23 of the reference manual)
+	);
+
+	// Only the swept channels lose their schmitt trigger. The other ADC
+	// pins keep working as digital inputs, ex. UART1 RX on PD6 (AIN6).
+	ADC1->TDRL |= (uint8_t)scanned;
+	ADC1->TDRH |= (uint8_t)(scanned >> 8);
+
+	ADC1_ScanModeCmd(ENABLE);		// Convert channels 0..last_channel into the data buffer
+	ADC1_ITConfig(ADC1_IT_EOCIE, ENABLE);	// Raise ADC1_IRQHandler once the sweep is done
+
+	_ready = FALSE;
+
+	ADC1_Cmd(ENABLE); // Wake ADC1 up from power down
+}
+
+void adc_scan_start(void)
+{
+	_ready = FALSE;
+	ADC1_StartConversion();
+}
+
+bool adc_scan_ready(void)
+{
+	return _ready;
+}
+
+const volatile uint16_t *adc_scan_results(void)
+{
+	return (const volatile uint16_t *)&ADC1->DB0RH;
+}
+
+void adc_scan_release(void)
+{
+	adc_scan_start(); // Hand the buffer back to the ADC
+}
+
+void adc_scan_isr(void)
+{
+	ADC1->CSR &= (uint8_t)(~ADC1_CSR_EOC); // Clear EOC flag
+	_ready = TRUE;
+}
+
+#endif /* ADC_MODE == ADC_MODE_SCAN */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Modules of the adc_led_threshold example that follow a
+ * 		clock switch (See clock.h)
+ *
+ * The ADC prescaler is shared by all acquisition modes and handled here.
+ * After a switch, the smallest divider is chosen that keeps fADC at or
+ * below the value the mode was built for (F_CPU divided by its PRESSEL
+ * option), so conversions never get faster than intended. Where even
+ * fCPU/18 exceeds that value, ex. at 16MHz with the default fCPU/18,
+ * fCPU/18 is used. The number of CPU cycles between two conversions then
+ * stays the same as at build time, which is what the main loop and the
+ * sample ring are sized for.
+ */
+
+#include <config.h>
+#include <clock.h>
+#include <adc_sampler.h>
+#include <adc_scan.h>
+#include <adc_awd.h>
+#include <uart.h>
+#include <soft_pwm.h>
+
+#if ADC_MODE == ADC_MODE_SCAN
+#define ADC_PRESSEL ADC_SCAN_PRESSEL
+#elif ADC_MODE == ADC_MODE_AWD
+#define ADC_PRESSEL ADC_AWD_PRESSEL
+#else
+#define ADC_PRESSEL ADC_SAMPLER_PRESSEL
+#endif
+
+// Highest ADC clock at VDD 2.95 to 5.5V (See the STM8S103 datasheet)
+#define ADC_CLOCK_MAX_HZ 4000000UL
+
+#define ADC_CONVERSION_CYCLES 14UL // ADC clock cycles per conversion
+
+// Divider of each SPSEL setting, ADC1_PRESSEL_FCPU_D2 to ADC1_PRESSEL_FCPU_D18
+static const uint8_t _adc_div[] = { 2, 3, 4, 6, 8, 10, 12, 18 };
+
+static uint8_t _adc_spsel(uint32_t hz)
+{
+	uint32_t target = F_CPU / _adc_div[ADC_PRESSEL >> 4];
+	uint8_t i;
+
+	for (i = 0; i < sizeof(_adc_div) - 1; i++) {
+		if (hz / _adc_div[i] <= target)
+			break;
+	}
+
+	return i;
+}
+
+static bool _adc_prepare(uint32_t hz)
+{
+	uint32_t adc_hz = hz / _adc_div[_adc_spsel(hz)];
+
+	if (adc_hz > ADC_CLOCK_MAX_HZ)
+		return FALSE;
+
+#if ADC_MODE == ADC_MODE_SINGLE && ADC_SAMPLE_RATE_HZ
+	// Each conversion must finish before TIM1 triggers the next one
+	if (adc_hz < ADC_CONVERSION_CYCLES * ADC_SAMPLE_RATE_HZ)
+		return FALSE;
+#endif
+
+	return TRUE;
+}
+
+// Writing CR1 while ADON is set starts a conversion. The sampler and the
+// analog watchdog convert continuously anyway, a scan sweep restarts and
+// overwrites the results, so do not switch between adc_scan_results()
+// and adc_scan_release().
+static void _adc_apply(uint32_t hz)
+{
+	ADC1_PrescalerConfig((ADC1_PresSel_TypeDef)(_adc_spsel(hz) << 4));
+}
+
+const clock_user_t clock_users[] = {
+	{ _adc_prepare, _adc_apply },
+#if ADC_MODE == ADC_MODE_SINGLE && ADC_SAMPLE_RATE_HZ
+	{ adc_sampler_clock_prepare, adc_sampler_clock_apply },	// TIM1 sample trigger
+#endif
+#if TELEMETRY
+	{ uart_clock_prepare, uart_clock_apply },		// Baud rate
+#endif
+#if LED_MODE == LED_MODE_SOFT_PWM
+	{ soft_pwm_clock_prepare, soft_pwm_clock_apply },	// Slot time unit
+#endif
+};
+
+const uint8_t clock_users_count = sizeof(clock_users) / sizeof(clock_users[0]);
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the fixed-point ADC filter and
+ * 		hysteresis comparator
+ *
+ * The STM8 has no barrel shifter and only a slow divider, so both filters
+ * are built around power-of-two shifts. Samples are 10-bit wide, which
+ * leaves 6 bits of headroom in a uint16_t accumulator:
+ *
+ *  - Moving average: Keeps the last 2^FILTER_SHIFT samples and a running
+ *    sum, so every update is one add and one subtract regardless of the
+ *    window size. RAM: 2^(FILTER_SHIFT+1) + 3 bytes.
+ *  - IIR: Keeps y scaled by 2^FILTER_SHIFT, so no fractional bits are lost
+ *    and acc += x - acc/2^FILTER_SHIFT needs no multiplication.
+ *    RAM: 2 bytes.
+ */
+
+#include <filter.h>
+
+#if FILTER_TYPE == FILTER_MOVING_AVG
+
+#define WINDOW_SIZE (1 << FILTER_SHIFT)
+
+static uint16_t _window[WINDOW_SIZE];
+static uint16_t _sum;
+static uint8_t _idx;
+
+void filter_reset(uint16_t initial)
+{
+	uint8_t i;
+
+	for (i = 0; i < WINDOW_SIZE; i++)
+		_window[i] = initial;
+
+	_sum = initial << FILTER_SHIFT;
+	_idx = 0;
+}
+
+uint16_t filter_update(uint16_t sample)
+{
+	_sum -= _window[_idx];	// Drop oldest sample
+	_sum += sample;		// Add newest sample
+	_window[_idx] = sample;
+	_idx = (_idx + 1) & (WINDOW_SIZE - 1);
+
+	return _sum >> FILTER_SHIFT;
+}
+
+#elif FILTER_TYPE == FILTER_IIR
+
+static uint16_t _acc; // Filter output scaled by 2^FILTER_SHIFT
+
+void filter_reset(uint16_t initial)
+{
+	_acc = initial << FILTER_SHIFT;
+}
+
+uint16_t filter_update(uint16_t sample)
+{
+	_acc = _acc - (_acc >> FILTER_SHIFT) + sample;
+	return _acc >> FILTER_SHIFT;
+}
+
+#else /* FILTER_NONE */
+
+void filter_reset(uint16_t initial)
+{
+	(void) initial;
+}
+
+uint16_t filter_update(uint16_t sample)
+{
+	return sample;
+}
+
+#endif /* FILTER_TYPE */
+
+static bool _state;
+
+void hysteresis_reset(bool state)
+{
+	_state = state;
+}
+
+bool hysteresis_update(uint16_t val)
+{
+	if (!_state && val > THRESHOLD_HIGH) {
+		_state = TRUE;
+		return TRUE;
+	}
+
+	if (_state && val < THRESHOLD_LOW) {
+		_state = FALSE;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+bool hysteresis_state(void)
+{
+	return _state;
+}
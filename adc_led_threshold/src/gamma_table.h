@@ -0,0 +1,83 @@
+// Generated by gamma.py from custom_pwm_gamma and custom_pwm_top in platformio.ini, do not edit.
+// Included by pwm.c and main.c, each only gets the table of its LED_MODE
+
+#define GAMMA_STEPS 256
+#define GAMMA_TOP   1023 // TIM2 auto-reload value
+
+#if LED_MODE == LED_MODE_SOFT_PWM
+
+// duty = round(255 * (i / 255)^2.2)
+static const uint8_t gamma_table_8[GAMMA_STEPS] = {
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   1,
+	  1,   1,   1,   1,   1,   1,   1,   1,
+	  1,   2,   2,   2,   2,   2,   2,   2,
+	  3,   3,   3,   3,   3,   4,   4,   4,
+	  4,   5,   5,   5,   5,   6,   6,   6,
+	  6,   7,   7,   7,   8,   8,   8,   9,
+	  9,   9,  10,  10,  11,  11,  11,  12,
+	 12,  13,  13,  13,  14,  14,  15,  15,
+	 16,  16,  17,  17,  18,  18,  19,  19,
+	 20,  20,  21,  22,  22,  23,  23,  24,
+	 25,  25,  26,  26,  27,  28,  28,  29,
+	 30,  30,  31,  32,  33,  33,  34,  35,
+	 35,  36,  37,  38,  39,  39,  40,  41,
+	 42,  43,  43,  44,  45,  46,  47,  48,
+	 49,  49,  50,  51,  52,  53,  54,  55,
+	 56,  57,  58,  59,  60,  61,  62,  63,
+	 64,  65,  66,  67,  68,  69,  70,  71,
+	 73,  74,  75,  76,  77,  78,  79,  81,
+	 82,  83,  84,  85,  87,  88,  89,  90,
+	 91,  93,  94,  95,  97,  98,  99, 100,
+	102, 103, 105, 106, 107, 109, 110, 111,
+	113, 114, 116, 117, 119, 120, 121, 123,
+	124, 126, 127, 129, 130, 132, 133, 135,
+	137, 138, 140, 141, 143, 145, 146, 148,
+	149, 151, 153, 154, 156, 158, 159, 161,
+	163, 165, 166, 168, 170, 172, 173, 175,
+	177, 179, 181, 182, 184, 186, 188, 190,
+	192, 194, 196, 197, 199, 201, 203, 205,
+	207, 209, 211, 213, 215, 217, 219, 221,
+	223, 225, 227, 229, 231, 234, 236, 238,
+	240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+#else
+
+// duty = round((GAMMA_TOP + 1) * (i / 255)^2.2)
+static const uint16_t gamma_table[GAMMA_STEPS] = {
+	    0,     0,     0,     0,     0,     0,     0,     0,
+	    1,     1,     1,     1,     1,     1,     2,     2,
+	    2,     3,     3,     3,     4,     4,     5,     5,
+	    6,     6,     7,     7,     8,     9,     9,    10,
+	   11,    11,    12,    13,    14,    15,    16,    16,
+	   17,    18,    19,    20,    21,    23,    24,    25,
+	   26,    27,    28,    30,    31,    32,    34,    35,
+	   36,    38,    39,    41,    42,    44,    46,    47,
+	   49,    51,    52,    54,    56,    58,    60,    61,
+	   63,    65,    67,    69,    71,    73,    76,    78,
+	   80,    82,    84,    87,    89,    91,    94,    96,
+	   99,   101,   104,   106,   109,   111,   114,   117,
+	  119,   122,   125,   128,   131,   133,   136,   139,
+	  142,   145,   148,   152,   155,   158,   161,   164,
+	  168,   171,   174,   178,   181,   184,   188,   191,
+	  195,   199,   202,   206,   210,   213,   217,   221,
+	  225,   229,   233,   237,   241,   245,   249,   253,
+	  257,   261,   265,   269,   274,   278,   282,   287,
+	  291,   296,   300,   305,   309,   314,   319,   323,
+	  328,   333,   338,   342,   347,   352,   357,   362,
+	  367,   372,   377,   383,   388,   393,   398,   404,
+	  409,   414,   420,   425,   431,   436,   442,   447,
+	  453,   459,   464,   470,   476,   482,   488,   494,
+	  499,   505,   511,   518,   524,   530,   536,   542,
+	  548,   555,   561,   568,   574,   580,   587,   593,
+	  600,   607,   613,   620,   627,   634,   640,   647,
+	  654,   661,   668,   675,   682,   689,   696,   704,
+	  711,   718,   725,   733,   740,   747,   755,   762,
+	  770,   778,   785,   793,   801,   808,   816,   824,
+	  832,   840,   848,   856,   864,   872,   880,   888,
+	  896,   904,   913,   921,   929,   938,   946,   955,
+	  963,   972,   980,   989,   998,  1006,  1015,  1024,
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Interrupt priority table of the adc_led_threshold example
+ *
+ * ADC1 must not wait behind the UART: with the sampler running at a
+ * calculated ~7.9k conversions/s, an EOC that is served late shortens the
+ * time the main loop has to drain the ring. The UART handlers only move
+ * single bytes and tolerate a delay of up to one character, 87us at
+ * 115200 baud or ~170 cycles at 2MHz by calculation. TX and RX
+ * share the flow control state (See uart.c) and therefore stay at the
+ * same level, so they never interrupt each other.
+ *
+ * The software PWM shares the top level with ADC1, so a UART handler
+ * cannot delay the start of a slot. An EOC pending at the same time still
+ * goes first and lengthens the slot that is ending by its handler.
+ */
+
+#include <config.h>
+#include <itc_priorities.h>
+
+#if ITC_PRIORITIES
+static const itc_priority_t _priorities[] = {
+	{ ITC_IRQ_ADC1,     ITC_PRIORITYLEVEL_3 },	// End of conversion, analog watchdog
+	{ ITC_IRQ_UART1_RX, ITC_PRIORITYLEVEL_2 },	// Telemetry flow control (See uart.c)
+	{ ITC_IRQ_UART1_TX, ITC_PRIORITYLEVEL_2 },	// Telemetry output
+#if LED_MODE == LED_MODE_SOFT_PWM
+	{ ITC_IRQ_TIM4_OVF, ITC_PRIORITYLEVEL_3 },	// Software PWM slots
+#endif
+};
+#endif
+
+void itc_priorities_init(void)
+{
+#if ITC_PRIORITIES
+	uint8_t i;
+
+	for (i = 0; i < sizeof(_priorities) / sizeof(_priorities[0]); i++)
+		ITC_SetSoftwarePriority(_priorities[i].irq, _priorities[i].level);
+#endif
+}
@@ -17,8 +17,30 @@
  * Description: Main file for the adc_led_threshold project.
  */
 
+// PlatformIO
 #include <stm8s.h>
 
+// include/
+#include <stm8s_it.h>
+#include <config.h>
+#include <adc_sampler.h>
+#include <adc_scan.h>
+#include <adc_awd.h>
+#include <filter.h>
+#include <uart.h>
+#include <telemetry.h>
+#include <bench.h>
+#include <spurious.h>
+#include <itc_priorities.h>
+#include <clock.h>
+#include <pwm.h>
+#include <soft_pwm.h>
+#include <pool.h>
+
+#if LED_MODE == LED_MODE_SOFT_PWM
+#include "gamma_table.h"
+#endif
+
 // Built-in LED
 #define LED_BUILTIN_PORT GPIOB
 #define LED_BUILTIN_PIN  GPIO_PIN_5
@@ -29,46 +51,173 @@
 #define POT_ADC_CHANNEL ADC1_CHANNEL_4 // Channel 4 is connected to GPIO PD3 (See STM8CubeMX pinout for STM8S103F3Px)
 #define POT_ADC_ADC_SCHMITTTRIG_CHANNEL ADC1_SCHMITTTRIG_CHANNEL4
 
-#define MAX_ADC_VAL 1023 // Max value of 10 Bit ADC
+// Last channel of a scan sweep (ADC_MODE_SCAN only)
+// On the STM8S103F3P6, AIN2..AIN6 are bonded out to PC4, PD2, PD3, PD5 and PD6
+#define SCAN_LAST_CHANNEL ADC1_CHANNEL_4
+
+#ifdef FILTER_PROFILE
+// Cycles spent filtering and comparing the last sample and the worst case
+// so far, measured with TIM2 running freely at fCPU.
+// Read both through a debugger memory dump or the simulator.
+volatile uint16_t filter_cycles;
+volatile uint16_t filter_cycles_max;
+
+static uint16_t tim2_count(void)
+{
+	uint16_t cnt = (uint16_t)TIM2->CNTRH << 8; // Reading the MSB latches the LSB
+	return cnt | TIM2->CNTRL;
+}
+#endif
 
 // Main routine
 void main(void)
 {
+	SPURIOUS_INIT(); // Check the spurious interrupt log that survived the reset (See spurious.h)
+
 	// Initialize GPIOs
-	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST);  // Built-in LED: Output with push-pull, low level and 10MHz
+	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_HIGH_FAST); // Built-in LED: Output with push-pull, high level (off) and 10MHz
 
 	GPIO_Init(POT_GPIO_PORT, POT_GPIO_PIN, GPIO_MODE_IN_FL_NO_IT);		  // Potentiometer: Input with floating input and no interrupts
 										  //                Floating input is recommended for ADC inputs by 
 										  // 		    the STM8S reference manual (See section 11.7.3, Table 23)
 
-	// Initialize ADC1
-	ADC1_Init(
-		ADC1_CONVERSIONMODE_CONTINUOUS,  // Continuous conversion mode
-		POT_ADC_CHANNEL,		 // Channel to convert
-		ADC1_PRESSEL_FCPU_D2,		 // Prescaler: fCPU/2
-		ADC1_EXTTRIG_GPIO,		 // External trigger: GPIO (Irrelevant, as we're disabling the trigger)
-		DISABLE, 			 // Disable triggers
-		ADC1_ALIGN_RIGHT,		 // ADC data alignment: Right (Lest significant 8 bits are in low register, most significant 2 bits in high register)
-		POT_ADC_ADC_SCHMITTTRIG_CHANNEL, // Selects schmitt trigger for channel 4
-		DISABLE				 // State to which selected schmitt trigger should be set to
-						 // Disabling schmitt trigger is recommended by the STM8S reference manual (See section 11.7.3, Table 23)
-	);
-	
-	ADC1_Cmd(ENABLE); // Enable ADC1
+	filter_reset(0);
+	hysteresis_reset(FALSE); // LED starts off
 
-	uint16_t adc_val = 0; // Stores ADC value
+#if LED_MODE == LED_MODE_PWM
+	pwm_init(); // Dim the LED on PD4 instead (See pwm.c)
+#elif LED_MODE == LED_MODE_SOFT_PWM
+	soft_pwm_init(); // Dim the built-in LED from TIM4 (See soft_pwm.c)
+#endif
+
+#if POOL_BLOCKS
+	pool_init();		// Static RAM blocks (See pool.h)
+#endif
+
+#if TELEMETRY
+	uart_init();		// Stream samples over UART1 (See uart.c)
+	telemetry_init();	// in binary frames (See telemetry.c)
+#endif
+
+	itc_priorities_init(); // Interrupt priorities, only writable while interrupts are disabled (See itc_priorities.h)
+
+#ifdef FILTER_PROFILE
+	TIM2->PSCR = 0;			// Count at fCPU
+	TIM2->CR1 |= TIM2_CR1_CEN;	// Free-running up to 0xFFFF
+#endif
+
+#if ADC_MODE == ADC_MODE_SCAN
+	// Initialize ADC1 to sweep channels 0..SCAN_LAST_CHANNEL (See adc_scan.c)
+	adc_scan_init(SCAN_LAST_CHANNEL);
+
+	enableInterrupts(); // Enable interrupts
+	adc_scan_start(); // Start first sweep
+#elif ADC_MODE == ADC_MODE_AWD
+	// Initialize ADC1 to watch the thresholds in hardware (See adc_awd.c)
+	adc_awd_init(POT_ADC_CHANNEL, POT_ADC_ADC_SCHMITTTRIG_CHANNEL);
+
+	enableInterrupts(); // Enable interrupts
+	adc_awd_start(); // Start continuous conversions
+#else
+	// Initialize ADC1 for interrupt driven sampling (See adc_sampler.c)
+	adc_sampler_init(POT_ADC_CHANNEL, POT_ADC_ADC_SCHMITTTRIG_CHANNEL);
+
+	enableInterrupts(); // Enable interrupts
+	adc_sampler_start(); // Start continuous conversions
+#endif
+
+#ifdef CLOCK_SOURCE
+	clock_switch(CLOCK_SOURCE); // Every module follows the new clock (See clock_users.c)
+#endif
+
+#if ADC_MODE == ADC_MODE_AWD
 	while(TRUE)
 	{
-		ADC1_StartConversion(); 				// Start conversion
-		while(ADC1_GetFlagStatus(ADC1_FLAG_EOC) == !SET); 	// Wait for conversion to finish
-		adc_val = ADC1_GetConversionValue(); 			// Get conversion value
-		ADC1_ClearFlag(ADC1_FLAG_EOC); 				// Clear EOC (End-Of-Conversion) flag
-		
-		if (adc_val > MAX_ADC_VAL/2)					// Pot is above half way
+		// Sleep until the analog watchdog reports a crossing. Crossings
+		// are rare, so the ISR must not slip in between check and wfi.
+		disableInterrupts();
+		while(!adc_awd_event()) {
+			wfi();
+			disableInterrupts();
+		}
+		enableInterrupts();
+
+		if (adc_awd_above())						// Pot has risen above THRESHOLD_HIGH
 			GPIO_WriteLow(LED_BUILTIN_PORT, LED_BUILTIN_PIN);	// Turn LED on
-		else								// Pot is below half way
+		else								// Pot has fallen below THRESHOLD_LOW
 			GPIO_WriteHigh(LED_BUILTIN_PORT, LED_BUILTIN_PIN);	// Turn LED off
 	}
+#else
+	uint16_t adc_val = 0; // Stores ADC value
+	while(TRUE)
+	{
+#if ADC_MODE == ADC_MODE_SCAN
+		// Sleep until the sweep has completed. A sweep raises EOC only
+		// once, so the check and wfi must not be separated by the ISR.
+		// wfi re-enables interrupts in the same instruction it halts with.
+		disableInterrupts();
+		while(!adc_scan_ready()) {
+			wfi();
+			disableInterrupts();
+		}
+		enableInterrupts();
+
+		const volatile uint16_t *results = adc_scan_results(); // Points into the ADC1 data buffer
+		adc_val = results[POT_ADC_CHANNEL];			// Other channels are available as results[0..SCAN_LAST_CHANNEL]
+		adc_scan_release();					// Start next sweep
+#else
+		// Sleep until the EOC interrupt has pushed a new sample.
+		// Should EOC fire between the check and wfi, we simply wake up
+		// on the next conversion, as the ADC runs in continuous mode.
+		while(!adc_sampler_available())
+			wfi();
+
+		adc_val = adc_sampler_read(); 				// Get conversion value
+#endif
+
+		BENCH_BEGIN(adc_iteration);
+
+#ifdef FILTER_PROFILE
+		uint16_t start = tim2_count();
+#endif
+
+		adc_val = filter_update(adc_val);			// Smooth out noise
+
+#if LED_MODE == LED_MODE_PWM
+		pwm_update(adc_val);					// Brightness follows the pot
+#elif LED_MODE == LED_MODE_SOFT_PWM
+		// The engine takes one set of duty cycles per frame
+		if (soft_pwm_ready()) {
+			uint8_t duty = gamma_table_8[(adc_val >> 2) & (GAMMA_STEPS - 1)];
+			uint8_t ch;
+
+			for (ch = 0; ch < SOFT_PWM_CHANNELS; ch++)
+				soft_pwm_set(ch, duty);			// Every channel follows the pot
+			soft_pwm_commit();
+		}
+#else
+		// Only touch the GPIO once the value has crossed the hysteresis band
+		if (hysteresis_update(adc_val)) {
+			if (hysteresis_state())					// Pot is above half way
+				GPIO_WriteLow(LED_BUILTIN_PORT, LED_BUILTIN_PIN);	// Turn LED on
+			else							// Pot is below half way
+				GPIO_WriteHigh(LED_BUILTIN_PORT, LED_BUILTIN_PIN);	// Turn LED off
+		}
+#endif
+
+#ifdef FILTER_PROFILE
+		filter_cycles = tim2_count() - start;
+		if (filter_cycles > filter_cycles_max)
+			filter_cycles_max = filter_cycles;
+#endif
+
+#if TELEMETRY
+		telemetry_push(adc_val); // Sent once the frame is full, never waits for the line
+#endif
+
+		BENCH_END(adc_iteration);
+	}
+#endif /* ADC_MODE == ADC_MODE_AWD */
 }
 
 // See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the static block pool
+ *
+ * A free block holds a pointer to the next free block in its first bytes,
+ * so the free list needs no RAM besides its head. A block in use belongs
+ * entirely to its owner.
+ */
+
+#include <stddef.h>
+
+#include <config.h>
+#include <pool.h>
+
+// Only built if POOL_BLOCKS is set (See config.h), SDCC does not drop unused functions
+#if POOL_BLOCKS
+
+typedef union pool_block {
+	union pool_block *next;		// While free
+	uint8_t data[POOL_BLOCK_SIZE];	// While in use
+} pool_block_t;
+
+static pool_block_t _blocks[POOL_BLOCKS];
+static pool_block_t *_free;
+static uint8_t _available;
+
+void pool_init(void)
+{
+	uint8_t i;
+
+	_free = NULL;
+	for (i = 0; i < POOL_BLOCKS; i++) {
+		_blocks[i].next = _free;
+		_free = &_blocks[i];
+	}
+
+	_available = POOL_BLOCKS;
+}
+
+void *pool_alloc(void)
+{
+	pool_block_t *block = _free;
+
+	if (block) {
+		_free = block->next;
+		_available--;
+	}
+
+	return block;
+}
+
+void pool_free(void *block)
+{
+	pool_block_t *b = block;
+
+	if (!b)
+		return;
+
+	b->next = _free;
+	_free = b;
+	_available++;
+}
+
+uint8_t pool_available(void)
+{
+	return _available;
+}
+
+#endif /* POOL_BLOCKS */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the hardware PWM LED dimming
+ *
+ * The built-in LED on PB5 has no timer channel, so the PWM is output on
+ * PD4, the default pin of TIM2_CH1. With the default auto-reload value of
+ * 1023, the PWM runs at 2MHz / 1024 = ~1.95kHz, well above visible
+ * flicker. The frequency scales with a clock switch (See clock.h), the
+ * duty cycle does not.
+ *
+ * CCR1 is preloaded, so a new duty cycle takes effect at the next counter
+ * overflow and a period is never cut short. The MSB of CCR1 is written
+ * first, as the timer only updates the register once the LSB is written.
+ */
+
+#include <config.h>
+#include <pwm.h>
+
+// Only built if LED_MODE is LED_MODE_PWM (See config.h), SDCC does not drop unused functions
+#if LED_MODE == LED_MODE_PWM
+
+#include "gamma_table.h"
+
+#define PWM_PORT GPIOD
+#define PWM_PIN  GPIO_PIN_4
+
+void pwm_init(void)
+{
+	GPIO_Init(PWM_PORT, PWM_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Low until the timer takes over
+
+	TIM2_TimeBaseInit(TIM2_PRESCALER_1, GAMMA_TOP);	// Count at fCPU from 0 to GAMMA_TOP
+	TIM2_OC1Init(
+		TIM2_OCMODE_PWM1,			// Output high while the counter is below CCR1
+		TIM2_OUTPUTSTATE_ENABLE,		// Drive PD4
+		0,					// LED off
+		TIM2_OCPOLARITY_HIGH			// LED lights up on high level
+	);
+	TIM2_OC1PreloadConfig(ENABLE);			// Update CCR1 at the overflow only
+	TIM2_ARRPreloadConfig(ENABLE);
+	TIM2_Cmd(ENABLE);
+}
+
+void pwm_update(uint16_t adc_val)
+{
+	uint16_t duty = gamma_table[(adc_val >> 2) & (GAMMA_STEPS - 1)];
+
+	TIM2->CCR1H = (uint8_t)(duty >> 8);
+	TIM2->CCR1L = (uint8_t)duty;
+}
+
+#endif /* LED_MODE == LED_MODE_PWM */
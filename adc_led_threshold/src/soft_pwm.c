@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the bit-angle modulated software PWM
+ *
+ * TIM4 counts one time unit of u CPU cycles per slot from 0 to u - 1 and
+ * its prescaler doubles the length of every following slot: slot k runs
+ * with a prescaler of 2^k, so a frame takes 255 * u cycles. At 2MHz and
+ * SOFT_PWM_HZ = 100, u is 78 cycles and a frame 19890 cycles, or 100.5Hz.
+ * The auto-reload value caps u at 256, the largest prescaler is 128.
+ *
+ * The prescaler is buffered by the timer and only taken over at the next
+ * update. The handler that starts slot k therefore writes the prescaler
+ * of slot k + 1 and outputs the pattern of slot k. Both happen at a fixed
+ * distance from the update event, so the interrupt latency delays every
+ * slot by the same amount and cancels out.
+ *
+ * The prescaler write has a deadline: it must land before the update that
+ * ends slot k, within u cycles of the update for slot 0. Otherwise slot
+ * k + 1 runs with the prescaler of slot k, at half its length, and every
+ * channel with bit k + 1 set loses 2^k steps of its duty cycle. The
+ * handler thus writes it, and clears the update flag, before anything
+ * else, which leaves the interrupt latency, the entry and the register
+ * saving of the handler as the limit, not its whole cost C.
+ *
+ * Per frame, the handler runs 8 times. Its cost C is a fixed part plus
+ * a read-modify-write of ODR for each port, so the CPU load is
+ * 8 * C / (255 * u). If C exceeds u, the update that ends slot 0 arrives
+ * while the handler still runs. Its flag is already cleared by then, so
+ * it is served right after the handler returns: the pattern of slot 1
+ * starts C - u cycles late, and slot 0 grows at the expense of slot 1
+ * without changing the length of the frame. At 16MHz, u is 256 and the
+ * frame rate 245Hz.
+ *
+ * The patterns are double buffered. soft_pwm_commit() fills the back
+ * buffer in the main context and the handler swaps the buffers at the
+ * end of a frame. Writing the back buffer is safe, as the handler only
+ * swaps once the commit is complete and does not look at it before.
+ *
+ * Other pins of the ports used here can still be written with the SPL
+ * GPIO_WriteHigh/Low functions, which SDCC turns into single bset/bres
+ * instructions, but not by read-modify-writes of ODR that the handler
+ * can interrupt.
+ */
+
+#include <config.h>
+#include <soft_pwm.h>
+
+// Only built if LED_MODE is LED_MODE_SOFT_PWM (See config.h), SDCC does not drop unused functions
+#if LED_MODE == LED_MODE_SOFT_PWM
+
+#if SOFT_PWM_CHANNELS < 1 || SOFT_PWM_CHANNELS > 8
+#error SOFT_PWM_CHANNELS must be between 1 and 8!
+#endif
+
+#define SLOTS 8 // One per bit of the duty cycle
+
+// Shortest time unit accepted, in CPU cycles. Leaves room for the
+// interrupt latency and the entry of the handler before the prescaler
+// write, by estimate (See the benchmark in bench/README.md for its cost).
+#define UNIT_MIN 64UL
+
+#define UNIT_MAX 256UL // TIM4 counts up to 255
+
+#define UNIT(hz) ((hz) / (SOFT_PWM_HZ * 255UL)) // CPU cycles per time unit, before capping
+
+#if UNIT(F_CPU) < UNIT_MIN
+#error F_CPU too low for SOFT_PWM_HZ!
+#endif
+
+typedef struct {
+	GPIO_TypeDef *port;
+	uint8_t pin;
+	bool active_low;	// Lit on low level, duty cycle is inverted
+} soft_pwm_pin_t;
+
+// Channels 0 to SOFT_PWM_CHANNELS - 1. Spread over as few ports as
+// possible, as each port adds to the cost of the handler. PA1 and PA2
+// are the HSE pins and must stay free for CLOCK_HSE.
+static const soft_pwm_pin_t _pins[] = {
+	{ GPIOB, GPIO_PIN_5, TRUE },	// Built-in LED
+	{ GPIOC, GPIO_PIN_3, FALSE },
+	{ GPIOC, GPIO_PIN_5, FALSE },
+	{ GPIOC, GPIO_PIN_6, FALSE },
+	{ GPIOC, GPIO_PIN_7, FALSE },
+	{ GPIOA, GPIO_PIN_3, FALSE },
+	{ GPIOA, GPIO_PIN_1, FALSE },
+	{ GPIOA, GPIO_PIN_2, FALSE },
+};
+
+static GPIO_TypeDef *_ports[SOFT_PWM_CHANNELS];	// Ports in use
+static uint8_t _keep[SOFT_PWM_CHANNELS];	// Pins of each port not driven by the PWM
+static uint8_t _port_count;
+static uint8_t _port_of[SOFT_PWM_CHANNELS];	// Index into _ports of each channel
+
+static uint8_t _duty[SOFT_PWM_CHANNELS];
+
+// Slot patterns, one byte per port and slot, slot after slot
+static uint8_t _buffers[2][SLOTS * SOFT_PWM_CHANNELS];
+
+static uint8_t *_frame;		// Buffer being output
+static const uint8_t *_out;	// Pattern of the slot the next update starts
+static uint8_t _slot;		// Slot the next update starts
+static volatile bool _pending;	// Back buffer holds a commit the handler has not taken yet
+
+static uint8_t _unit(uint32_t hz)
+{
+	uint32_t unit = UNIT(hz);
+
+	if (unit > UNIT_MAX)
+		unit = UNIT_MAX;
+
+	return (uint8_t)(unit - 1); // Auto-reload value
+}
+
+void soft_pwm_init(void)
+{
+	uint8_t ch, i;
+
+	_port_count = 0;
+	for (ch = 0; ch < SOFT_PWM_CHANNELS; ch++) {
+		for (i = 0; i < _port_count && _ports[i] != _pins[ch].port; i++)
+			;
+
+		if (i == _port_count) {
+			_ports[i] = _pins[ch].port;
+			_keep[i] = 0xFF;
+			_port_count++;
+		}
+
+		_port_of[ch] = i;
+		_keep[i] &= (uint8_t)(~_pins[ch].pin);
+
+		GPIO_Init(_pins[ch].port, (GPIO_Pin_TypeDef)_pins[ch].pin,
+			  _pins[ch].active_low ? GPIO_MODE_OUT_PP_HIGH_FAST : GPIO_MODE_OUT_PP_LOW_FAST); // Off
+	}
+
+	for (ch = 0; ch < SOFT_PWM_CHANNELS; ch++)
+		_duty[ch] = 0;
+
+	_frame = _buffers[0];
+	_pending = FALSE;
+	soft_pwm_commit();	// Patterns of the channels off, into _buffers[1]
+	_frame = _buffers[1];	// Taken right away, the handler does not run yet
+	_pending = FALSE;
+
+	_out = _frame;
+	_slot = 0;
+
+	TIM4_DeInit();
+	TIM4_TimeBaseInit(TIM4_PRESCALER_1, _unit(F_CPU));	// First update starts slot 0 with a prescaler of 1
+	TIM4_ARRPreloadConfig(ENABLE);				// Keep the slot running when the unit changes (See soft_pwm_clock_apply())
+	TIM4_ClearFlag(TIM4_FLAG_UPDATE);
+	TIM4_ITConfig(TIM4_IT_UPDATE, ENABLE);			// Raise TIM4_UPD_OVF_IRQHandler on every update
+	TIM4_Cmd(ENABLE);
+}
+
+bool soft_pwm_ready(void)
+{
+	return !_pending;
+}
+
+void soft_pwm_set(uint8_t channel, uint8_t duty)
+{
+	if (channel < SOFT_PWM_CHANNELS)
+		_duty[channel] = duty;
+}
+
+bool soft_pwm_commit(void)
+{
+	uint8_t *back;
+	uint8_t ch, k, duty, pin;
+	uint8_t i;
+
+	if (_pending)
+		return FALSE;
+
+	// The handler does not swap while nothing is pending
+	back = _frame == _buffers[0] ? _buffers[1] : _buffers[0];
+
+	for (i = 0; i < SLOTS * SOFT_PWM_CHANNELS; i++)
+		back[i] = 0;
+
+	for (ch = 0; ch < SOFT_PWM_CHANNELS; ch++) {
+		duty = _pins[ch].active_low ? (uint8_t)(~_duty[ch]) : _duty[ch];
+		pin = _pins[ch].pin;
+		i = _port_of[ch];
+
+		for (k = 0; k < SLOTS; k++) {
+			if (duty & 1)
+				back[i] |= pin;
+
+			duty >>= 1;
+			i += _port_count;
+		}
+	}
+
+	_pending = TRUE;
+	return TRUE;
+}
+
+bool soft_pwm_clock_prepare(uint32_t hz)
+{
+	return UNIT(hz) >= UNIT_MIN;
+}
+
+// ARR is preloaded, so the slot that is running keeps its length
+void soft_pwm_clock_apply(uint32_t hz)
+{
+	TIM4->ARR = _unit(hz);
+}
+
+void soft_pwm_isr(void)
+{
+	const uint8_t *out = _out;
+	GPIO_TypeDef *port;
+	uint8_t i;
+
+	// Prescaler first, it must be written before the slot ends (See above)
+	_slot = (_slot + 1) & (SLOTS - 1);
+	TIM4->PSCR = _slot; // Prescaler of 2^slot, taken over by the next update
+	TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF); // Clear update flag, an update from now on raises the handler again
+
+	// Output next, so the slot starts at a fixed distance from the update
+	for (i = 0; i < _port_count; i++) {
+		port = _ports[i];
+		port->ODR = (uint8_t)((port->ODR & _keep[i]) | out[i]);
+	}
+
+	if (_slot) {
+		_out = out + _port_count;
+	} else {
+		// Frame complete
+		if (_pending) {
+			_frame = _frame == _buffers[0] ? _buffers[1] : _buffers[0];
+			_pending = FALSE;
+		}
+		_out = _frame;
+	}
+}
+
+#endif /* LED_MODE == LED_MODE_SOFT_PWM */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the binary telemetry framing
+ *
+ * Samples are packed straight into the frame as they arrive, so the only
+ * per-sample work is storing the low byte and merging two bits into the
+ * group's fifth byte. Once the frame is full, the CRC is computed with one
+ * table lookup per byte, and the frame is COBS encoded straight into the
+ * UART TX ring, so no second buffer is needed for the encoded frame.
+ *
+ * Every frame lives in a block of the RAM pool (See pool.h), from its
+ * first sample until it has been copied into the TX ring. If the ring
+ * cannot take a complete frame yet, the frame waits in its block and the
+ * next one is packed into another, while every group of 4 samples tries
+ * to send the waiting frame again. Only if a frame is still waiting when
+ * the next one completes, or no block is free, is the new frame dropped
+ * rather than waiting for the line, and the gap shows up in seq on the
+ * receiving end.
+ */
+
+#include <stddef.h>
+
+#include <config.h>
+#include <telemetry.h>
+
+// Only built if TELEMETRY is set (See config.h)
+#if TELEMETRY
+
+#if POOL_BLOCKS < 1
+#error TELEMETRY needs at least one POOL_BLOCKS, two to let a frame wait for the UART!
+#endif
+
+// CRC-8, polynomial x^8 + x^2 + x + 1 (0x07), MSB first
+static const uint8_t _crc8_table[256] = {
+	0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+	0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+	0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+	0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+	0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+	0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+	0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+	0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+	0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+	0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+	0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+	0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+	0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+	0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+	0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+	0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+static uint8_t *_frame;		// Pool block of the frame being packed
+static uint8_t *_waiting;	// Pool block of a complete frame the TX ring had no room for, or NULL
+static uint8_t _seq;
+static uint8_t _count;		// Samples in the current frame
+static uint8_t *_group;		// First byte of the current group of 4 samples
+static uint16_t _dropped;	// Frames that did not fit into the TX ring or the pool
+
+static uint8_t crc8(const uint8_t *buf, uint8_t len)
+{
+	uint8_t crc = 0;
+
+	while (len--)
+		crc = _crc8_table[crc ^ *buf++];
+
+	return crc;
+}
+
+// Writes the COBS encoding of a frame into the TX ring: every 0x00 is
+// replaced with the distance to the next one (or the end of the frame) and
+// the result is terminated with 0x00. Frames are shorter than the UART TX
+// ring, which is at most 128 bytes, so a run of non-zero bytes never
+// reaches the 254 byte limit of a COBS block, and the encoded frame is
+// always TELEMETRY_ENCODED_LEN bytes long. All or nothing, a partial frame
+// would only be discarded by the receiver.
+static bool send(const uint8_t *frame)
+{
+	uint8_t start = 0;
+	uint8_t end;
+
+	if (uart_tx_free() < TELEMETRY_ENCODED_LEN)
+		return FALSE;
+
+	do {
+		for (end = start; end < TELEMETRY_FRAME_LEN && frame[end]; end++)
+			;
+
+		uart_putc(end - start + 1);			// Code byte
+		uart_write(&frame[start], end - start);	// Bytes up to the 0x00 it replaces
+		start = end + 1;
+	} while (start <= TELEMETRY_FRAME_LEN);
+
+	uart_putc(0); // Frame delimiter
+
+	return TRUE;
+}
+
+static void send_waiting(void)
+{
+	if (_waiting && send(_waiting)) {
+		pool_free(_waiting);
+		_waiting = NULL;
+	}
+}
+
+static void start_frame(void)
+{
+	_frame[0] = _seq++;
+	_group = &_frame[1];
+	_count = 0;
+}
+
+void telemetry_init(void)
+{
+	_frame = pool_alloc();
+	_waiting = NULL;
+	_seq = 0;
+	_dropped = 0;
+	start_frame();
+}
+
+void telemetry_push(uint16_t sample)
+{
+	uint8_t slot = _count & 3;
+	uint8_t *next;
+
+	_group[slot] = (uint8_t)sample;				// Low 8 bits
+	if (slot == 0)
+		_group[4] = (uint8_t)(sample >> 8) & 0x03;	// Top 2 bits, first of the group
+	else
+		_group[4] |= (uint8_t)((sample >> 8) & 0x03) << (slot * 2);
+
+	if (slot == 3) {
+		_group += 5;
+		send_waiting(); // Once per group, the line drains a few bytes meanwhile
+	}
+
+	if (++_count < TELEMETRY_SAMPLES)
+		return;
+
+	_frame[TELEMETRY_FRAME_LEN - 1] = crc8(_frame, TELEMETRY_FRAME_LEN - 1);
+
+	// Frames go out in order, so this one may only be sent once none waits
+	if (!_waiting && !send(_frame)) {
+		next = pool_alloc();
+		if (next) {
+			_waiting = _frame;
+			_frame = next;
+		} else {
+			_dropped++;
+		}
+	} else if (_waiting) {
+		_dropped++;
+	}
+
+	start_frame(); // Into the block of the frame that was sent or dropped, or a new one
+}
+
+// Only written by the main loop, no need to guard against torn reads
+uint16_t telemetry_dropped(void)
+{
+	return _dropped;
+}
+
+#endif /* TELEMETRY */
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the interrupt driven UART1 driver
+ *
+ * Both rings follow the same scheme as the ADC sampler ring: one side only
+ * ever writes the head, the other only the tail, and both are single bytes,
+ * so no side has to disable interrupts.
+ *
+ * The TX interrupt (TXE) is only enabled while there is something to send.
+ * uart_write() sets TIEN after queueing, the TX ISR clears it once the ring
+ * is empty. Both use bset/bres, which the CPU cannot interrupt halfway, so
+ * the read-modify-write of CR2 from main and ISR never loses an update.
+ */
+
+#include <config.h>
+#include <uart.h>
+
+// Only built if TELEMETRY is set (See config.h)
+#if TELEMETRY
+
+#define TX_MASK (UART_TX_SIZE - 1)
+#define RX_MASK (UART_RX_SIZE - 1)
+
+// Baud rate divider, rounded to the nearest integer
+#define UART_DIV ((F_CPU + UART_BAUD / 2) / UART_BAUD)
+
+#if UART_DIV < 16 || UART_DIV > 0xFFFF
+#error UART_BAUD out of range for F_CPU!
+#endif
+
+// Receivers tolerate a few percent, refuse anything beyond 3%
+#if (F_CPU / UART_DIV > UART_BAUD && (F_CPU / UART_DIV - UART_BAUD) * 100 > UART_BAUD * 3) || \
+    (F_CPU / UART_DIV < UART_BAUD && (UART_BAUD - F_CPU / UART_DIV) * 100 > UART_BAUD * 3)
+#error UART_BAUD cannot be generated from F_CPU within 3%!
+#endif
+
+static uint8_t _tx_ring[UART_TX_SIZE];
+static volatile uint8_t _tx_head;	// Written by main loop only
+static volatile uint8_t _tx_tail;	// Written by TX ISR only
+
+static uint8_t _rx_ring[UART_RX_SIZE];
+static volatile uint8_t _rx_head;	// Written by RX ISR only
+static volatile uint8_t _rx_tail;	// Written by main loop only
+static volatile uint16_t _rx_overruns;	// Bytes lost to a full ring or a hardware overrun
+
+#if UART_FLOW_XONXOFF
+static volatile bool _tx_paused;	// Peer sent XOFF
+static volatile bool _xoff_sent;	// We sent XOFF and owe the peer an XON
+static volatile uint8_t _flow_send;	// XON/XOFF waiting to jump the TX queue, 0 if none
+#endif
+
+// BRR2 must be written before BRR1, as writing BRR1 updates the divider
+// (See section 22.7.3 of the STM8S reference manual)
+static void _set_divider(uint16_t div)
+{
+	UART1->BRR2 = (uint8_t)(((div >> 8) & 0xF0) | (div & 0x0F));
+	UART1->BRR1 = (uint8_t)(div >> 4);
+}
+
+// Same rules as the compile time checks of UART_DIV, returns 0 if
+// UART_BAUD cannot be generated from hz
+static uint16_t _divider(uint32_t hz)
+{
+	uint32_t div = (hz + UART_BAUD / 2) / UART_BAUD;
+	uint32_t baud, err;
+
+	if (div < 16 || div > 0xFFFF)
+		return 0;
+
+	baud = hz / div;
+	err = baud > UART_BAUD ? baud - UART_BAUD : UART_BAUD - baud;
+	if (err * 100 > UART_BAUD * 3)
+		return 0;
+
+	return (uint16_t)div;
+}
+
+void uart_init(void)
+{
+	UART1->CR2 = 0; // Disable transmitter, receiver and interrupts while configuring
+
+	// 8 data bits, no parity, 1 stop bit (Reset state of CR1 and CR3)
+	UART1->CR1 = 0;
+	UART1->CR3 = 0;
+
+	_set_divider(UART_DIV);
+
+	_tx_head = 0;
+	_tx_tail = 0;
+	_rx_head = 0;
+	_rx_tail = 0;
+	_rx_overruns = 0;
+#if UART_FLOW_XONXOFF
+	_tx_paused = FALSE;
+	_xoff_sent = FALSE;
+	_flow_send = 0;
+#endif
+
+	// Enable transmitter, receiver and the RXNE/overrun interrupt.
+	// TXE is only enabled once there is data to send.
+	UART1->CR2 = UART1_CR2_TEN | UART1_CR2_REN | UART1_CR2_RIEN;
+}
+
+uint8_t uart_tx_free(void)
+{
+	return UART_TX_SIZE - (uint8_t)(_tx_head - _tx_tail);
+}
+
+// Queues up to len bytes and returns how many fit, never waits
+uint8_t uart_write(const uint8_t *buf, uint8_t len)
+{
+	uint8_t room = uart_tx_free();
+	uint8_t i;
+
+	if (len > room)
+		len = room;
+
+	for (i = 0; i < len; i++)
+		_tx_ring[(uint8_t)(_tx_head + i) & TX_MASK] = buf[i];
+
+	_tx_head += len;		// Publish all bytes at once
+	UART1->CR2 |= UART1_CR2_TIEN;	// Let the TX ISR pick them up
+
+	return len;
+}
+
+bool uart_putc(uint8_t c)
+{
+	return uart_write(&c, 1) == 1;
+}
+
+uint8_t uart_available(void)
+{
+	return (uint8_t)(_rx_head - _rx_tail);
+}
+
+// Dequeues up to len bytes and returns how many were available, never waits
+uint8_t uart_read(uint8_t *buf, uint8_t len)
+{
+	uint8_t avail = uart_available();
+	uint8_t i;
+
+	if (len > avail)
+		len = avail;
+
+	for (i = 0; i < len; i++)
+		buf[i] = _rx_ring[(uint8_t)(_rx_tail + i) & RX_MASK];
+
+	_rx_tail += len; // Hand the slots back to the RX ISR
+
+#if UART_FLOW_XONXOFF
+	// Drained to half, let the peer resume. The RX ISR only sends XOFF
+	// while _xoff_sent is cleared, so queue XON before clearing it.
+	if (_xoff_sent && uart_available() <= UART_RX_SIZE / 2) {
+		_flow_send = UART_XON;
+		_xoff_sent = FALSE;
+		UART1->CR2 |= UART1_CR2_TIEN;
+	}
+#endif
+
+	return len;
+}
+
+uint16_t uart_rx_overruns(void)
+{
+	uint16_t ret;
+
+	// 16-bit counter is written by the ISR, read it twice to avoid a torn value
+	do {
+		ret = _rx_overruns;
+	} while (ret != _rx_overruns);
+
+	return ret;
+}
+
+// Called with interrupts disabled, so the TX ISR cannot start another
+// byte. The one on the line is finished at the old baud rate, bytes still
+// in the ring follow at the new one once interrupts are enabled again.
+// Bytes received during the switch may be garbled.
+bool uart_clock_prepare(uint32_t hz)
+{
+	if (!_divider(hz))
+		return FALSE;
+
+	while (!(UART1->SR & UART1_SR_TC))
+		;
+
+	return TRUE;
+}
+
+void uart_clock_apply(uint32_t hz)
+{
+	_set_divider(_divider(hz));
+}
+
+void uart_tx_isr(void)
+{
+#if UART_FLOW_XONXOFF
+	// Flow control characters are sent even while paused
+	if (_flow_send) {
+		UART1->DR = _flow_send; // Writing DR clears TXE
+		_flow_send = 0;
+		return;
+	}
+
+	if (_tx_paused) {
+		UART1->CR2 &= (uint8_t)(~UART1_CR2_TIEN); // Resumed by XON in the RX ISR
+		return;
+	}
+#endif
+
+	if (_tx_head == _tx_tail) {
+		UART1->CR2 &= (uint8_t)(~UART1_CR2_TIEN); // Nothing left, stop TXE interrupts
+		return;
+	}
+
+	UART1->DR = _tx_ring[_tx_tail & TX_MASK]; // Writing DR clears TXE
+	_tx_tail++; // Hand the slot back to the main loop
+}
+
+void uart_rx_isr(void)
+{
+	// Reading SR followed by DR clears RXNE as well as the overrun flag
+	uint8_t sr = UART1->SR;
+	uint8_t c = UART1->DR;
+
+	if (sr & UART1_SR_OR)
+		_rx_overruns++; // At least one byte arrived before we read the previous one
+
+#if UART_FLOW_XONXOFF
+	if (c == UART_XOFF) {
+		_tx_paused = TRUE;
+		return;
+	}
+
+	if (c == UART_XON) {
+		_tx_paused = FALSE;
+		UART1->CR2 |= UART1_CR2_TIEN; // Pick up where we left off
+		return;
+	}
+#endif
+
+	if ((uint8_t)(_rx_head - _rx_tail) == UART_RX_SIZE) {
+		_rx_overruns++; // Main loop fell behind, drop the byte
+		return;
+	}
+
+	_rx_ring[_rx_head & RX_MASK] = c;
+	_rx_head++; // Publish the byte only after it has been written
+
+#if UART_FLOW_XONXOFF
+	if (!_xoff_sent && (uint8_t)(_rx_head - _rx_tail) >= UART_RX_SIZE - UART_RX_HEADROOM) {
+		_xoff_sent = TRUE;
+		_flow_send = UART_XOFF;
+		UART1->CR2 |= UART1_CR2_TIEN;
+	}
+#endif
+}
+
+#endif /* TELEMETRY */
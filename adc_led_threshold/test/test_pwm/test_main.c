@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Checks the TIM2 compare values that pwm_update() (See
+ * 		../../src/pwm.c) writes for filtered ADC values on the
+ * 		host build (See ../../../host/README.md).
+ *
+ * 		Run with: pio test -e native_pwm
+ */
+
+#include <stm8s.h>
+#include <unity.h>
+
+#include <config.h>
+#include <pwm.h>
+
+#undef main // build_flags apply to the test as well, only the firmware's main() is renamed
+
+#if LED_MODE != LED_MODE_PWM
+#error Build with LED_MODE=LED_MODE_PWM, run pio test -e native_pwm!
+#endif
+
+// TIM2 auto-reload value for custom_pwm_top = 1023 in platformio.ini
+#define TOP 1023
+
+static uint16_t _ccr1(void)
+{
+	return ((uint16_t)TIM2->CCR1H << 8) | TIM2->CCR1L;
+}
+
+static uint16_t _duty(uint16_t adc_val)
+{
+	pwm_update(adc_val);
+	return _ccr1();
+}
+
+void setUp(void)
+{
+	host_reset();
+	pwm_init();
+}
+
+void tearDown(void)
+{
+}
+
+// PWM mode 1 on channel 1, preloaded, counting at fCPU up to TOP
+static void test_init(void)
+{
+	TEST_ASSERT_EQUAL_UINT16(TOP, ((uint16_t)TIM2->ARRH << 8) | TIM2->ARRL);
+	TEST_ASSERT_EQUAL_HEX8(TIM2_PRESCALER_1, TIM2->PSCR);
+	TEST_ASSERT_EQUAL_HEX8(TIM2_OCMODE_PWM1, TIM2->CCMR1 & TIM2_CCMR_OCM);
+	TEST_ASSERT_TRUE(TIM2->CCMR1 & TIM2_CCMR_OCxPE);
+	TEST_ASSERT_TRUE(TIM2->CCER1 & TIM2_CCER1_CC1E);
+	TEST_ASSERT_TRUE(TIM2->CR1 & TIM2_CR1_CEN);
+	TEST_ASSERT_EQUAL_UINT16(0, _ccr1());	// LED off until the first sample
+}
+
+// Fully off at the bottom, and a compare value above TOP keeps the
+// output high for the whole period at the top
+static void test_ends(void)
+{
+	TEST_ASSERT_EQUAL_UINT16(0, _duty(0));
+	TEST_ASSERT_EQUAL_UINT16(TOP + 1, _duty(1023));
+}
+
+// round((TOP + 1) * (i / 255)^2.2) for the default custom_pwm_gamma = 2.2,
+// at index i = adc_val / 4
+static void test_gamma_values(void)
+{
+	TEST_ASSERT_EQUAL_UINT16(0, _duty(1 * 4));
+	TEST_ASSERT_EQUAL_UINT16(49, _duty(64 * 4));
+	TEST_ASSERT_EQUAL_UINT16(225, _duty(128 * 4));
+	TEST_ASSERT_EQUAL_UINT16(548, _duty(192 * 4));
+	TEST_ASSERT_EQUAL_UINT16(1015, _duty(254 * 4));
+}
+
+// The lower 2 bits of the 10-bit value do not change the duty cycle
+static void test_upper_bits_only(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < 1024; i += 4) {
+		uint16_t duty = _duty(i);
+
+		TEST_ASSERT_EQUAL_UINT16(duty, _duty(i + 1));
+		TEST_ASSERT_EQUAL_UINT16(duty, _duty(i + 3));
+	}
+}
+
+// The brightness never drops while the pot is turned up
+static void test_monotonic(void)
+{
+	uint16_t prev = 0, duty, i;
+
+	for (i = 0; i < 1024; i += 4) {
+		duty = _duty(i);
+		TEST_ASSERT_TRUE(duty >= prev);
+		prev = duty;
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_init);
+	RUN_TEST(test_ends);
+	RUN_TEST(test_gamma_values);
+	RUN_TEST(test_upper_bits_only);
+	RUN_TEST(test_monotonic);
+	return UNITY_END();
+}
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Host side decoder for the binary telemetry frames sent by
+#              the adc_led_threshold example (See include/telemetry.h).
+#              Reads from a serial port, a TCP socket (ex. the serial port
+#              of the ucsim simulator), a file or stdin, and reports the
+#              frame, sample and error rates as well as the measured
+#              framing overhead.
+#
+# Usage:       telemetry_decode.py /dev/ttyUSB0 [--baud 115200]
+#              telemetry_decode.py tcp:localhost:5678
+#              telemetry_decode.py capture.bin
+#              telemetry_decode.py - < capture.bin
+#
+# Only the Python standard library is used.
+
+import argparse
+import os
+import socket
+import sys
+import termios
+import time
+import tty
+
+def _crc8_table():
+	table = []
+	for i in range(256):
+		crc = i
+		for _ in range(8):
+			crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+		table.append(crc)
+	return table
+
+CRC8_TABLE = _crc8_table()
+
+def crc8(data):
+	crc = 0
+	for b in data:
+		crc = CRC8_TABLE[crc ^ b]
+	return crc
+
+def cobs_decode(data):
+	"""Decodes one COBS frame without its 0x00 delimiter, None if malformed"""
+	out = bytearray()
+	i = 0
+	while i < len(data):
+		code = data[i]
+		if code == 0 or i + code > len(data):
+			return None
+		out += data[i + 1:i + code]
+		i += code
+		if code < 0xFF and i < len(data):
+			out.append(0)
+	return bytes(out)
+
+def unpack_samples(packed):
+	samples = []
+	for g in range(0, len(packed) - 4, 5):
+		top = packed[g + 4]
+		for slot in range(4):
+			samples.append(packed[g + slot] | ((top >> (slot * 2)) & 0x03) << 8)
+	return samples
+
+class Stats:
+	def __init__(self):
+		self.wire_bytes = 0	# Everything received, including delimiters
+		self.frames = 0		# Frames with a valid CRC
+		self.bad_frames = 0	# Malformed COBS, wrong length or CRC mismatch
+		self.lost_frames = 0	# Gaps in seq
+		self.samples = 0
+		self.last_seq = None
+
+	def report(self, elapsed, out=sys.stderr):
+		elapsed = max(elapsed, 1e-9)
+		payload = self.samples * 10 / 8 # Packed 10-bit samples without any framing
+		overhead = 100.0 * (self.wire_bytes - payload) / self.wire_bytes if self.wire_bytes else 0.0
+		print("%.1fs: %d frames, %d bad, %d lost | %.0f samples/s, %.0f bytes/s | "
+		      "%.2f bytes/sample, framing overhead %.1f%%" % (
+			elapsed, self.frames, self.bad_frames, self.lost_frames,
+			self.samples / elapsed, self.wire_bytes / elapsed,
+			self.wire_bytes / self.samples if self.samples else 0.0, overhead),
+		      file=out)
+
+def handle_frame(raw, stats, dump):
+	frame = cobs_decode(raw)
+	if frame is None or len(frame) < 2 + 5 or (len(frame) - 2) % 5 != 0 or crc8(frame[:-1]) != frame[-1]:
+		stats.bad_frames += 1
+		return
+
+	seq = frame[0]
+	if stats.last_seq is not None:
+		stats.lost_frames += (seq - stats.last_seq - 1) & 0xFF
+	stats.last_seq = seq
+
+	samples = unpack_samples(frame[1:-1])
+	stats.frames += 1
+	stats.samples += len(samples)
+
+	if dump:
+		print("\n".join(str(s) for s in samples))
+
+def open_source(source, baud):
+	"""Returns a function that reads a chunk of bytes, b'' on end of input"""
+	if source == "-":
+		return lambda: sys.stdin.buffer.read1(4096)
+
+	if source.startswith("tcp:"):
+		host, port = source[4:].rsplit(":", 1)
+		sock = socket.create_connection((host, int(port)))
+		return lambda: sock.recv(4096)
+
+	fd = os.open(source, os.O_RDONLY | os.O_NOCTTY)
+	if os.isatty(fd):
+		# Raw mode, no XON/XOFF interpretation: the frames are binary
+		tty.setraw(fd)
+		attr = termios.tcgetattr(fd)
+		speed = getattr(termios, "B%d" % baud)
+		attr[4] = attr[5] = speed
+		attr[0] &= ~(termios.IXON | termios.IXOFF)
+		termios.tcsetattr(fd, termios.TCSANOW, attr)
+	return lambda: os.read(fd, 4096)
+
+def main():
+	parser = argparse.ArgumentParser(description="Decode adc_led_threshold telemetry frames")
+	parser.add_argument("source", help="Serial device, tcp:HOST:PORT, file or - for stdin")
+	parser.add_argument("--baud", type=int, default=115200, help="Baud rate of a serial device")
+	parser.add_argument("--samples", action="store_true", help="Print every decoded sample to stdout")
+	parser.add_argument("--interval", type=float, default=1.0, help="Seconds between reports")
+	args = parser.parse_args()
+
+	read = open_source(args.source, args.baud)
+	stats = Stats()
+	buf = bytearray()
+	synced = False # Drop everything up to the first delimiter, we may have started mid-frame
+	start = last_report = time.monotonic()
+
+	try:
+		while True:
+			chunk = read()
+			if not chunk:
+				break
+
+			stats.wire_bytes += len(chunk)
+			for b in chunk:
+				if b != 0:
+					buf.append(b)
+					continue
+				if synced and buf:
+					handle_frame(bytes(buf), stats, args.samples)
+				synced = True
+				buf.clear()
+
+			now = time.monotonic()
+			if now - last_report >= args.interval:
+				stats.report(now - start)
+				last_report = now
+	except KeyboardInterrupt:
+		pass
+
+	stats.report(time.monotonic() - start)
+	return 1 if stats.bad_frames else 0
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,418 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Benchmark harness for the example projects. Builds every
+#              project with -D BENCH through PlatformIO, runs the firmware
+#              in the ucsim sstm8 simulator and reports the cycles spent in
+#              the named regions (See common/stm8s_common/include/bench.h), as
+#              well as the flash and RAM usage taken from the map file.
+#
+#              Optionally compares the results against a baseline and exits
+#              with a non-zero status on any regression, so it can be run
+#              headless on a CI machine.
+#
+# Usage:       bench.py [--baseline bench/baseline.json] [--update-baseline]
+#                       [--json results.json] [project ...]
+#
+# Requires:    PlatformIO (pio) and ucsim (sstm8) in PATH
+
+import argparse
+import configparser
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Projects and the regions measured in them. A region starts at the begin
+# symbol and ends at the end symbol, both taken from the map file. Symbols
+# placed by BENCH_BEGIN/BENCH_END are called bench_<name>_begin/_end. ISR
+# regions start at the handler's own symbol and end with None, which stands
+# for the handler's iret, and cover it from interrupt entry to exit.
+#
+# An entry with "dir" is a variant of the project in that directory, built
+# with the additional "flags". "expect" maps regions to (cycles, tolerance),
+# a region outside of that range fails the run regardless of the baseline.
+# The cycles are a function of the board_build.f_cpu the project is built
+# for (See f_cpu()).
+PROJECTS = {
+	"blink_delay_asm": {
+		"regions": {
+			"delay_ms_1":    ("bench_delay_ms_1_begin", "bench_delay_ms_1_end"),
+			"delay_cycles_1000": ("bench_delay_cycles_1000_begin", "bench_delay_cycles_1000_end"),
+			"delay_us_100":  ("bench_delay_us_100_begin", "bench_delay_us_100_end"),
+			"delay_us_10000": ("bench_delay_us_10000_begin", "bench_delay_us_10000_end"),
+			"gpio_toggle":   ("bench_gpio_toggle_begin", "bench_gpio_toggle_end"),
+		},
+		# Requested cycles, delay_cycles/delay_us must be within one 3
+		# cycle loop of them
+		"expect": {
+			"delay_cycles_1000": (lambda f_cpu: 1000, 3),
+			"delay_us_100":  (lambda f_cpu: 100 * f_cpu // 1000000, 3),
+			"delay_us_10000": (lambda f_cpu: 10000 * f_cpu // 1000000, 3),
+		},
+	},
+	"blink_delay_timer": {
+		"regions": {
+			"tim4_isr":      ("_TIM4_UPD_OVF_IRQHandler", None),
+		},
+	},
+	"blink_button": {
+		"regions": {
+			"poll_loop":     ("bench_poll_loop_begin", "bench_poll_loop_end"),
+		},
+	},
+	"adc_led_threshold": {
+		"regions": {
+			"adc_isr":       ("_ADC1_IRQHandler", None),
+			"adc_iteration": ("bench_adc_iteration_begin", "bench_adc_iteration_end"),
+		},
+	},
+	# Software PWM handler with the channels on 1, 2 and 3 ports, the
+	# number of channels per port does not change its cost
+	"soft_pwm_1ch": {
+		"dir": "adc_led_threshold",
+		"flags": "-D LED_MODE=LED_MODE_SOFT_PWM -D SOFT_PWM_CHANNELS=1",
+		"regions": {
+			"soft_pwm_isr":  ("_TIM4_UPD_OVF_IRQHandler", None),
+		},
+	},
+	"soft_pwm_5ch": {
+		"dir": "adc_led_threshold",
+		"flags": "-D LED_MODE=LED_MODE_SOFT_PWM -D SOFT_PWM_CHANNELS=5",
+		"regions": {
+			"soft_pwm_isr":  ("_TIM4_UPD_OVF_IRQHandler", None),
+		},
+	},
+	"soft_pwm_8ch": {
+		"dir": "adc_led_threshold",
+		"flags": "-D LED_MODE=LED_MODE_SOFT_PWM -D SOFT_PWM_CHANNELS=8",
+		"regions": {
+			"soft_pwm_isr":  ("_TIM4_UPD_OVF_IRQHandler", None),
+		},
+	},
+	"toggle_led_interrupt": {
+		"regions": {}, # Every region depends on a button press, only sizes are reported
+	},
+}
+
+# Areas of the SDCC linker that end up in flash and in RAM
+FLASH_AREAS = ("HOME", "GSINIT", "GSFINAL", "CONST", "INITIALIZER", "CODE")
+RAM_AREAS = ("DATA", "INITIALIZED")
+
+BUILD_DIR = os.path.join(".pio", "bench") # Keeps the regular build untouched
+
+# Added to ISR regions, which are measured from the handler's first
+# instruction up to its iret: the context the CPU saves on interrupt entry
+# (RM0016, 9 cycles) and the iret itself (PM0044, 11 cycles)
+ISR_ENTRY_CYCLES = 9
+IRET_CYCLES = 11
+
+IRET = 0x80
+
+DEFAULT_F_CPU = 16000000 # Of the stm8sblue board, without board_build.f_cpu
+
+class BenchError(Exception):
+	pass
+
+def build(project, pio):
+	spec = PROJECTS[project]
+	project_dir = spec.get("dir", project)
+	flags = " ".join(f for f in (spec.get("flags"), "-D BENCH") if f)
+
+	# Variants get a build directory of their own, so they do not
+	# rebuild each other
+	build_dir = BUILD_DIR if "dir" not in spec else BUILD_DIR + "-" + project
+
+	env = dict(os.environ)
+	env["PLATFORMIO_BUILD_FLAGS"] = (env.get("PLATFORMIO_BUILD_FLAGS", "") + " " + flags).strip()
+	env["PLATFORMIO_BUILD_DIR"] = build_dir
+
+	proc = subprocess.run([pio, "run", "-d", os.path.join(ROOT, project_dir)], env=env,
+			      stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+	if proc.returncode != 0:
+		sys.stderr.write(proc.stdout)
+		raise BenchError("build of %s failed" % project)
+
+	build_dir = os.path.join(ROOT, project_dir, build_dir)
+	ihx = glob.glob(os.path.join(build_dir, "*", "firmware.ihx"))
+	maps = glob.glob(os.path.join(build_dir, "*", "firmware.map"))
+	if not ihx or not maps:
+		raise BenchError("no firmware.ihx/firmware.map found in %s" % build_dir)
+
+	return ihx[0], maps[0]
+
+def f_cpu(project):
+	"""CPU clock in Hz the firmware environment of a project is built for"""
+	ini = configparser.ConfigParser(inline_comment_prefixes=(";",))
+	ini.read(os.path.join(ROOT, PROJECTS[project].get("dir", project), "platformio.ini"))
+	value = ini.get("env:stm8sblue", "board_build.f_cpu", fallback=str(DEFAULT_F_CPU))
+
+	return int(value.rstrip("UuLl"))
+
+def parse_map(path):
+	"""Returns ({area: size}, {symbol: address}) from an SDCC (sdld) map file"""
+	areas = {}
+	symbols = {}
+	area_re = re.compile(r"^(\w+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+=\s+(\d+)\.\s+bytes")
+	symbol_re = re.compile(r"^\s+([0-9A-Fa-f]{4,8})\s+([A-Za-z_.$][\w.$]*)\b")
+
+	with open(path) as f:
+		for line in f:
+			m = area_re.match(line)
+			if m:
+				areas.setdefault(m.group(1), int(m.group(4)))
+				continue
+			m = symbol_re.match(line)
+			if m:
+				symbols[m.group(2)] = int(m.group(1), 16)
+
+	return areas, symbols
+
+def parse_ihx(path):
+	"""Returns {address: byte} of an Intel HEX file"""
+	mem = {}
+
+	with open(path) as f:
+		for line in f:
+			line = line.strip()
+			if not line.startswith(":"):
+				continue
+			data = bytes.fromhex(line[1:])
+			count, addr, rtype = data[0], (data[1] << 8) | data[2], data[3]
+			if rtype == 0x00:
+				for i in range(count):
+					mem[addr + i] = data[4 + i]
+
+	return mem
+
+def find_iret(handler, symbols, mem):
+	"""Address of the iret ending the handler. SDCC emits a single epilogue
+	   at the end of the function, so the iret is the last byte before the
+	   next symbol."""
+	start = symbols[handler]
+	following = [a for a in symbols.values() if a > start]
+	addr = min(following) - 1 if following else None
+
+	if addr is None or mem.get(addr) != IRET:
+		raise BenchError("iret of %s not found before the next symbol, end its region with BENCH_END instead" % handler)
+
+	return addr
+
+def simulate(ihx, breakpoints, stops, sstm8, cpu, timeout):
+	"""Runs the firmware until `stops` breakpoints were hit and returns a list
+	   of (pc, clks) pairs, one per hit. Fewer hits are returned if the
+	   simulation times out before, ex. because a region is never reached."""
+	cmds = ["break 0x%x" % addr for addr in sorted(set(breakpoints))]
+	cmds += ["run", "state"] * stops
+	cmds.append("quit")
+
+	try:
+		proc = subprocess.run([sstm8, "-t", cpu, ihx], input="\n".join(cmds) + "\n",
+				      stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+				      universal_newlines=True, timeout=timeout)
+		out = proc.stdout
+	except subprocess.TimeoutExpired as e:
+		out = e.stdout.decode() if isinstance(e.stdout, bytes) else (e.stdout or "")
+
+	# "run" reports "Stop at 0x008123: (104) Breakpoint", "state" the total
+	# clks along with the ones in and outside of interrupts, only the first
+	# following each stop is taken
+	hits = []
+	pc = None
+	for m in re.finditer(r"Stop at (0x[0-9a-fA-F]+)|\((\d+) clks\)", out):
+		if m.group(1):
+			pc = int(m.group(1), 16)
+		elif pc is not None:
+			hits.append((pc, int(m.group(2))))
+			pc = None
+
+	if not hits:
+		raise BenchError("no breakpoint hit, sstm8 -t %s printed:\n%s" % (cpu, out[-2000:]))
+
+	return hits
+
+def measure(hits, begin, end):
+	"""Cycles between every begin hit and the end hit following it"""
+	samples = []
+	start = None
+
+	for pc, clks in hits:
+		if pc == begin:
+			start = clks
+		elif pc == end and start is not None:
+			samples.append(clks - start)
+			start = None
+
+	return samples
+
+def run_project(project, args):
+	ihx, map_path = build(project, args.pio)
+	areas, symbols = parse_map(map_path)
+
+	result = {
+		"flash": sum(areas.get(a, 0) for a in FLASH_AREAS),
+		"ram": sum(areas.get(a, 0) for a in RAM_AREAS),
+		"regions": {},
+	}
+
+	regions = PROJECTS[project]["regions"]
+	if not regions:
+		return result
+
+	mem = parse_ihx(ihx)
+	addrs = {}
+	for name, (begin, end) in regions.items():
+		if begin not in symbols or (end is not None and end not in symbols):
+			raise BenchError("%s: symbols of region %s not found in %s" % (project, name, map_path))
+		addrs[name] = (symbols[begin], symbols[end] if end is not None else find_iret(begin, symbols, mem))
+
+	breakpoints = [a for pair in addrs.values() for a in pair]
+	hits = simulate(ihx, breakpoints, 2 * args.samples * len(regions), args.sstm8, args.cpu, args.timeout)
+
+	for name, (begin, end) in addrs.items():
+		samples = measure(hits, begin, end)
+		if regions[name][1] is None:
+			samples = [ISR_ENTRY_CYCLES + s + IRET_CYCLES for s in samples]
+		result["regions"][name] = {
+			"min": min(samples),
+			"max": max(samples),
+			"hits": len(samples),
+		} if samples else None # Not reached within the timeout
+
+	return result
+
+def print_results(results):
+	print("%-22s %-14s %8s %8s %6s" % ("project", "region", "min", "max", "hits"))
+	for project, res in results.items():
+		print("%-22s %-14s %8s %8s %6s" % (project, "flash [B]", res["flash"], "", ""))
+		print("%-22s %-14s %8s %8s %6s" % (project, "ram [B]", res["ram"], "", ""))
+		for name, r in res["regions"].items():
+			if r is None:
+				print("%-22s %-14s %8s %8s %6s" % (project, name, "-", "-", 0))
+			else:
+				print("%-22s %-14s %8d %8d %6d" % (project, name, r["min"], r["max"], r["hits"]))
+
+def compare(results, baseline, tolerance):
+	"""Returns a list of regressions against the baseline"""
+	regressions = []
+
+	def check(what, new, old):
+		if old is None:
+			return
+		if new is None:
+			regressions.append("%s: no longer reached" % what)
+		elif new > old * (1 + tolerance / 100.0):
+			regressions.append("%s: %d -> %d" % (what, old, new))
+
+	for project, res in results.items():
+		base = baseline.get(project)
+		if base is None:
+			continue
+
+		check("%s flash" % project, res["flash"], base["flash"])
+		check("%s ram" % project, res["ram"], base["ram"])
+		for name, old in base["regions"].items():
+			new = res["regions"].get(name)
+			check("%s %s" % (project, name), new and new["max"], old and old["max"])
+
+	return regressions
+
+def check_expected(results):
+	"""Returns a list of regions outside of their expected cycles"""
+	failures = []
+
+	for project, res in results.items():
+		for name, (expected, tolerance) in PROJECTS[project].get("expect", {}).items():
+			cycles = expected(f_cpu(project))
+			r = res["regions"].get(name)
+			if r is None:
+				failures.append("%s %s: not reached" % (project, name))
+			elif r["min"] < cycles - tolerance or r["max"] > cycles + tolerance:
+				failures.append("%s %s: %d to %d cycles, expected %d +/- %d" %
+						(project, name, r["min"], r["max"], cycles, tolerance))
+
+	return failures
+
+def main():
+	parser = argparse.ArgumentParser(description="Benchmark the example projects under ucsim")
+	parser.add_argument("projects", nargs="*", help="Projects to benchmark (Default: all)")
+	parser.add_argument("--samples", type=int, default=3, help="Passes through each region")
+	parser.add_argument("--timeout", type=float, default=60, help="Seconds of simulation per project")
+	parser.add_argument("--baseline", help="JSON file to compare the results against")
+	parser.add_argument("--update-baseline", action="store_true", help="Write the results to --baseline")
+	parser.add_argument("--tolerance", type=float, default=0, help="Allowed increase in percent")
+	parser.add_argument("--json", help="Also write the results to this JSON file")
+	parser.add_argument("--pio", default="pio", help="PlatformIO executable")
+	parser.add_argument("--sstm8", default="sstm8", help="ucsim STM8 simulator executable")
+	parser.add_argument("--cpu", default="STM8S103", help="CPU type passed to sstm8 -t")
+	args = parser.parse_args()
+
+	for tool in (args.pio, args.sstm8):
+		if shutil.which(tool) is None:
+			sys.exit("error: %s not found in PATH" % tool)
+
+	projects = args.projects or list(PROJECTS)
+	for project in projects:
+		if project not in PROJECTS:
+			sys.exit("error: unknown project %s" % project)
+
+	results = {}
+	try:
+		for project in projects:
+			results[project] = run_project(project, args)
+	except BenchError as e:
+		sys.exit("error: %s" % e)
+
+	print_results(results)
+
+	if args.json:
+		with open(args.json, "w") as f:
+			json.dump(results, f, indent=2, sort_keys=True)
+
+	failures = check_expected(results)
+	for f in failures:
+		print("OUT OF RANGE: %s" % f)
+
+	if not args.baseline:
+		return 1 if failures else 0
+
+	if args.update_baseline:
+		with open(args.baseline, "w") as f:
+			json.dump(results, f, indent=2, sort_keys=True)
+		return 1 if failures else 0
+
+	if not os.path.exists(args.baseline):
+		# Nothing to compare against until a baseline is committed, the
+		# expected cycles above are still checked
+		print("warning: no baseline at %s, skipping the comparison, record one with --update-baseline" % args.baseline)
+		return 1 if failures else 0
+
+	with open(args.baseline) as f:
+		regressions = compare(results, json.load(f), args.tolerance)
+
+	for r in regressions:
+		print("REGRESSION: %s" % r)
+
+	return 1 if regressions or failures else 0
+
+if __name__ == "__main__":
+	sys.exit(main())
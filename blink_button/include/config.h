@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Build time configuration for the blink_button example
+ * 		Every option can be overridden through the build_flags
+ * 		option in platformio.ini, ex. -D BUTTON_MODE=BUTTON_MODE_EXTI
+ */
+
+#ifndef _CONFIG_H_INCLUDED_
+#define _CONFIG_H_INCLUDED_
+
+// Button input modes
+#define BUTTON_MODE_POLL 0 // Main loop polls the button and writes the LED on every pass
+#define BUTTON_MODE_EXTI 1 // Both-edges interrupt mirrors the button, core halted in between
+
+#ifndef BUTTON_MODE
+#define BUTTON_MODE BUTTON_MODE_POLL
+#endif
+
+#endif /* _CONFIG_H_INCLUDED_ */
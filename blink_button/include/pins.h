@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Pin definitions for the blink_button example
+ */
+
+#ifndef _PINS_H_INCLUDED_
+#define _PINS_H_INCLUDED_
+
+// Button
+#define BTN_PORT 	 GPIOD
+#define BTN_PIN  	 GPIO_PIN_3
+
+// Built-in LED (Pin B5, Active Low)
+#define LED_BUILTIN_PORT GPIOB
+#define LED_BUILTIN_PIN  GPIO_PIN_5
+
+#endif /* _PINS_H_INCLUDED_ */
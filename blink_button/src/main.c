@@ -17,38 +17,64 @@
  * Description: Displays the button state on the built in LED
  * 		If the button is pressed, the LED will turn on
  * 		If the button is released, the LED will turn off
+ *
+ * 		By default, the button is polled in a tight loop. If
+ * 		BUTTON_MODE is set to BUTTON_MODE_EXTI (See config.h), the
+ * 		core is halted instead and the LED is only written when
+ * 		the button changes, by EXTI_PORTD_IRQHandler in stm8s_it.c
  * 
  * Pin Out:	BTN + : PD3
  *              BTN - : GND 
  */
 
+// PlatformIO
 #include <stm8s.h>
 
-// Button
-#define BTN_PORT 	 GPIOD
-#define BTN_PIN  	 GPIO_PIN_3
-
-// Built-in LED (Pin B5, Active Low)
-#define LED_BUILTIN_PORT GPIOB
-#define LED_BUILTIN_PIN  GPIO_PIN_5
+// include/
+#include <stm8s_it.h>
+#include <config.h>
+#include <pins.h>
+#include <gpio_fast.h>
+#include <bench.h>
+#include <spurious.h>
 
 // Main routine
 void main(void)
 {	
+	SPURIOUS_INIT(); // Check the spurious interrupt log that survived the reset (See spurious.h)
+
 	// Initialize GPIOs
-	GPIO_Init(BTN_PORT, BTN_PIN, GPIO_MODE_IN_PU_NO_IT);			 // Button: Input with pull-up, no interrupts
-	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
+	GPIO_INIT(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
+
+#if BUTTON_MODE == BUTTON_MODE_EXTI
+	GPIO_INIT(BTN_PORT, BTN_PIN, GPIO_MODE_IN_PU_IT);			 // Button: Input with pull-up, interrupt enabled
+	EXTI_SetExtIntSensitivity(EXTI_PORT_GPIOD, EXTI_SENSITIVITY_RISE_FALL);	 // Interrupt on press and release
+
+	// Show the initial state, any change from here on raises the interrupt
+	if (GPIO_READ(BTN_PORT, BTN_PIN))
+		GPIO_HIGH(LED_BUILTIN_PORT, LED_BUILTIN_PIN);
+	enableInterrupts();
+
+	while(TRUE)
+		halt(); // Sleep until the button changes
+#else
+	GPIO_INIT(BTN_PORT, BTN_PIN, GPIO_MODE_IN_PU_NO_IT);			 // Button: Input with pull-up, no interrupts
 
 	while(TRUE) {
+		BENCH_BEGIN(poll_loop);
+
 		// Button released
-		if (GPIO_ReadInputPin(BTN_PORT, BTN_PIN)) {
-			GPIO_WriteHigh(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Turn off LED
+		if (GPIO_READ(BTN_PORT, BTN_PIN)) {
+			GPIO_HIGH(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Turn off LED
 		}
 		// Button pressed
 		else {
-			GPIO_WriteLow(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Turn on LED
+			GPIO_LOW(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Turn on LED
 		}
+
+		BENCH_END(poll_loop);
 	}
+#endif
 }
 
 // See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Fires unused interrupt handlers on the host build (See
+ * 		../../../host/README.md) and checks the spurious interrupt
+ * 		log (See spurious.h) and the masking of their sources.
+ *
+ * 		Run with: pio test -e native_spurious
+ */
+
+#include <stm8s.h>
+#include <unity.h>
+
+#include <stm8s_it.h>
+#include <spurious.h>
+
+#undef main // build_flags apply to the test as well, only the firmware's main() is renamed
+
+#if !SPURIOUS_LOG || !SPURIOUS_MASK_AFTER
+#error Build with SPURIOUS_LOG and SPURIOUS_MASK_AFTER set, run pio test -e native_spurious!
+#endif
+
+void setUp(void)
+{
+	host_reset();
+	spurious_clear();
+}
+
+void tearDown(void)
+{
+}
+
+// RAM holds random values after power-up, the log starts over
+static void test_power_up(void)
+{
+	spurious_log.magic = 0x1234;
+	spurious_log.total = 77;
+	spurious_log.hits[3] = 5;
+
+	spurious_init();
+
+	TEST_ASSERT_EQUAL_HEX16(SPURIOUS_MAGIC, spurious_log.magic);
+	TEST_ASSERT_EQUAL_UINT16(0, spurious_log.total);
+	TEST_ASSERT_EQUAL_UINT8(0, spurious_log.hits[3]);
+	TEST_ASSERT_EQUAL_UINT8(0, spurious_log.resets);
+}
+
+// A valid log survives a reset and counts it
+static void test_reset_keeps_log(void)
+{
+	EXTI_PORTA_IRQHandler();
+	spurious_init();
+	spurious_init();
+
+	TEST_ASSERT_EQUAL_UINT16(1, spurious_log.total);
+	TEST_ASSERT_EQUAL_UINT8(1, spurious_log.hits[3]);
+	TEST_ASSERT_EQUAL_UINT8(2, spurious_log.resets);
+}
+
+static void test_counts_per_vector(void)
+{
+	EXTI_PORTA_IRQHandler();
+	EXTI_PORTA_IRQHandler();
+	AWU_IRQHandler();
+
+	TEST_ASSERT_EQUAL_UINT16(3, spurious_log.total);
+	TEST_ASSERT_EQUAL_UINT8(2, spurious_log.hits[3]);
+	TEST_ASSERT_EQUAL_UINT8(1, spurious_log.hits[1]);
+	TEST_ASSERT_EQUAL_UINT8(1, spurious_log.last);
+}
+
+// The interrupt enable bits stay set until the vector has fired
+// SPURIOUS_MASK_AFTER times
+static void test_mask_timer(void)
+{
+	uint8_t i;
+
+	TIM2->IER = TIM2_IER_UIE;
+
+	for (i = 0; i < SPURIOUS_MASK_AFTER - 1; i++)
+		TIM2_UPD_OVF_BRK_IRQHandler();
+	TEST_ASSERT_EQUAL_HEX8(TIM2_IER_UIE, TIM2->IER);
+
+	TIM2_UPD_OVF_BRK_IRQHandler();
+	TEST_ASSERT_EQUAL_HEX8(0, TIM2->IER);
+	TEST_ASSERT_EQUAL_UINT8(SPURIOUS_MASK_AFTER, spurious_log.hits[13]);
+}
+
+// Only the inputs of a port are masked, CR2 of an output sets its speed
+static void test_mask_port_keeps_outputs(void)
+{
+	uint8_t i;
+
+	GPIOA->DDR = GPIO_PIN_3;			// PA3 output
+	GPIOA->CR2 = GPIO_PIN_3 | GPIO_PIN_2;		// PA3 fast, PA2 interrupt enabled
+
+	for (i = 0; i < SPURIOUS_MASK_AFTER; i++)
+		EXTI_PORTA_IRQHandler();
+
+	TEST_ASSERT_EQUAL_HEX8(GPIO_PIN_3, GPIOA->CR2);
+}
+
+// Masking one vector leaves the other sources alone
+static void test_mask_only_own_source(void)
+{
+	uint8_t i;
+
+	TIM2->IER = TIM2_IER_UIE;
+	GPIOA->CR2 = GPIO_PIN_2;
+
+	for (i = 0; i < SPURIOUS_MASK_AFTER; i++)
+		EXTI_PORTA_IRQHandler();
+
+	TEST_ASSERT_EQUAL_HEX8(0, GPIOA->CR2);
+	TEST_ASSERT_EQUAL_HEX8(TIM2_IER_UIE, TIM2->IER);
+}
+
+// The trap instruction cannot be masked, its count saturates
+static void test_trap_saturates(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < 300; i++)
+		TRAP_IRQHandler();
+
+	TEST_ASSERT_EQUAL_UINT8(0xFF, spurious_log.hits[SPURIOUS_TRAP]);
+	TEST_ASSERT_EQUAL_UINT16(300, spurious_log.total);
+	TEST_ASSERT_EQUAL_UINT8(SPURIOUS_TRAP, spurious_log.last);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_power_up);
+	RUN_TEST(test_reset_keeps_log);
+	RUN_TEST(test_counts_per_vector);
+	RUN_TEST(test_mask_timer);
+	RUN_TEST(test_mask_port_keeps_outputs);
+	RUN_TEST(test_mask_only_own_source);
+	RUN_TEST(test_trap_saturates);
+	return UNITY_END();
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Header file for the cycle counted delay functions
+ * 
+ * All loop counts are derived from F_CPU at compile time. delay_cycles()
+ * and delay_us() expect constant arguments, so the conversion to loop
+ * counts is folded by the compiler and costs nothing at run time.
+ * 
+ */
+
+#ifndef _DELAY_H_INCLUDED_
+#define _DELAY_H_INCLUDED_
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#error "F_CPU not defined"
+#endif
+
+#if F_CPU % 1000UL != 0
+#error "F_CPU must be a multiple of 1kHz"
+#endif
+
+// Cycles per iteration of the inner loop: decw x (1) & jrne (2)
+#define DELAY_LOOP_CYCLES 3
+
+// Cycles spent on a _delay_loops() call besides the loop itself, that is
+// loading the argument, call and ret, minus the one cycle the final, not
+// taken jrne saves. The argument is passed in x (__sdcccall(1), default
+// since SDCC 4.2) or on the stack (__sdcccall(0)), the latter also
+// requiring a push, a load from the stack and a pop.
+#if defined(__SDCCCALL) && __SDCCCALL == 1
+#define DELAY_CALL_CYCLES 9 // ldw x,#n (2) call (4) ret (4) - 1
+#else
+#define DELAY_CALL_CYCLES 15 // ldw x,#n (2) pushw x (2) call (4) ldw x,(3,sp) (2) ret (4) addw sp,#2 (2) - 1
+#endif
+
+// Loop count for a delay of c cycles, at least one loop
+#define DELAY_CYCLES_TO_LOOPS(c) \
+	((uint16_t)(((c) > DELAY_CALL_CYCLES + DELAY_LOOP_CYCLES) ? \
+		(((c) - DELAY_CALL_CYCLES) / DELAY_LOOP_CYCLES) : 1))
+
+// Longest delay_cycles() delay, 65535 loops of the 16-bit counter plus the call
+#define DELAY_MAX_CYCLES (DELAY_CALL_CYCLES + 65535UL * DELAY_LOOP_CYCLES)
+
+// Busy waits for c CPU cycles (c must be a constant). Longer delays than
+// DELAY_MAX_CYCLES would be truncated by the 16-bit loop count and fail to
+// compile instead, use delay_ms for those.
+#define delay_cycles(c) do { \
+	_Static_assert((uint32_t)(c) <= DELAY_MAX_CYCLES, "delay too long for delay_cycles/delay_us, use delay_ms"); \
+	_delay_loops(DELAY_CYCLES_TO_LOOPS((uint32_t)(c))); \
+} while (0)
+
+// Busy waits for us microseconds (us must be a constant)
+#define delay_us(us) delay_cycles((uint32_t)(us) * (F_CPU / 1000UL) / 1000UL)
+
+void _delay_loops(uint16_t loops);
+void delay_ms(uint16_t ms);
+
+#endif /* _DELAY_H_INCLUDED_ */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the cycle counted delay functions
+ * 
+ */
+
+#include <delay.h>
+
+// Each millisecond costs:
+//   ldw x, _DELAY_MS_LOOPS (2) + inner loop (3 * loops - 1) + padding nops + decw y (1) + jrne (2)
+// = 3 * loops + 4 + padding
+// The loop count and padding are chosen so that this adds up to exactly F_CPU/1000.
+#define CYCLES_PER_MS (F_CPU / 1000UL)
+#define MS_OVERHEAD 4
+
+#if CYCLES_PER_MS < MS_OVERHEAD + DELAY_LOOP_CYCLES
+#error F_CPU too low for delay_ms!
+#endif
+
+#define MS_PADDING ((CYCLES_PER_MS - MS_OVERHEAD) % DELAY_LOOP_CYCLES)
+
+const uint16_t DELAY_MS_LOOPS = (CYCLES_PER_MS - MS_OVERHEAD) / DELAY_LOOP_CYCLES; // Inner loops per millisecond
+
+// Both functions are __naked, so SDCC emits neither prologue nor ret and
+// the asm blocks pick their argument up exactly where the calling
+// convention left it: in x for __sdcccall(1) (default since SDCC 4.2), or
+// on the stack above the return address for __sdcccall(0). No global
+// variable is involved, so the functions are reentrant and may be called
+// from ISRs. x and y are caller-saved in SDCC, so they may be clobbered.
+
+void _delay_loops(uint16_t loops) __naked {
+	(void) loops;
+	__asm
+#if !defined(__SDCCCALL) || __SDCCCALL == 0
+		ldw x, (3, sp)		// Load loops argument from stack: 2 cycles
+#endif
+	0000$:
+		decw x			// Decrease loop counter: 1 cycle
+		jrne 0000$		// Loop until x == 0: 2 cycles (except for x == 0 where it's just 1 cycle)
+		ret			// 4 cycles
+	__endasm;
+}
+
+// The call overhead of a few cycles is not compensated for, it is spent
+// once per call and does not accumulate with the delay
+void delay_ms(uint16_t ms) __naked {
+	(void) ms;
+	__asm
+#if !defined(__SDCCCALL) || __SDCCCALL == 0
+		ldw y, (3, sp)		// Load ms argument from stack into y register: 2 cycles
+#else
+		ldw y, x		// Move ms argument into y register: 1 cycle
+#endif
+	0000$:
+		ldw x, _DELAY_MS_LOOPS	// Load loop counter into x register: 2 cycles
+	0001$:
+		decw x			// Decrease loop counter: 1 cycle
+		jrne 0001$		// Check if 1ms passed: 2 cycles (except for x == 0 where it's just 1 cycle)
+#if MS_PADDING >= 1
+		nop			// Pad millisecond to exactly F_CPU/1000 cycles: 1 cycle
+#endif
+#if MS_PADDING >= 2
+		nop			// 1 cycle
+#endif
+		decw y			// Decrease ms counter: 1 cycle
+		jrne 0000$		// Check if provided time has passed: 2 cycles (except for y == 0 where it's just 1 cycle)
+		ret			// 4 cycles
+	__endasm;
+}
@@ -22,11 +22,20 @@
 #include <stm8s.h>
 
 // include/
-#include <delay_ms.h>
+#include <delay.h>
+#include <bench.h>
 
-#if F_CPU != 2000000UL
-#error F_CPU set to wrong value! This example runs on 2MHz!
-#error Please set the board_build.f_cpu option the platformio.ini file to 2000000UL!
+// HSI divider matching F_CPU, the CPU clock itself is not divided further
+#if F_CPU == 16000000UL
+#define CKDIVR_HSIDIV 0x00 // HSI/1
+#elif F_CPU == 8000000UL
+#define CKDIVR_HSIDIV 0x08 // HSI/2
+#elif F_CPU == 4000000UL
+#define CKDIVR_HSIDIV 0x10 // HSI/4
+#elif F_CPU == 2000000UL
+#define CKDIVR_HSIDIV 0x18 // HSI/8 (Reset default)
+#else
+#error F_CPU must be 16, 8, 4 or 2MHz! Please set the board_build.f_cpu option in the platformio.ini file accordingly!
 #endif
 
 // Built-in LED (Pin B5, Active Low)
@@ -35,11 +44,35 @@
 
 void main(void)
 {
+	CLK->CKDIVR = CKDIVR_HSIDIV; // Run the CPU at F_CPU, the delay loops are computed for it
+
 	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
 
+#ifdef BENCH
+	BENCH_BEGIN(delay_ms_1);
+	delay_ms(1); // Should take F_CPU/1000 cycles plus the call
+	BENCH_END(delay_ms_1);
+
+	// Each should take the requested cycles to within one loop, the
+	// harness checks this (See bench/bench.py)
+	BENCH_BEGIN(delay_cycles_1000);
+	delay_cycles(1000);
+	BENCH_END(delay_cycles_1000);
+
+	BENCH_BEGIN(delay_us_100);
+	delay_us(100);
+	BENCH_END(delay_us_100);
+
+	BENCH_BEGIN(delay_us_10000);
+	delay_us(10000); // Fits into DELAY_MAX_CYCLES at every F_CPU, up to ~12ms at 16MHz
+	BENCH_END(delay_us_10000);
+#endif
+
 	while(TRUE)
 	{
+		BENCH_BEGIN(gpio_toggle);
 		GPIO_WriteReverse(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Toggle built-in LED
+		BENCH_END(gpio_toggle);
 		delay_ms(1000);
 	}
 }
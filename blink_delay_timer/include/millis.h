@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Millisecond time base driven by the TIM4 update interrupt
+ * 
+ */
+
+#ifndef _MILLIS_H_INCLUDED_
+#define _MILLIS_H_INCLUDED_
+
+#include <stm8s.h>
+
+#ifndef F_CPU
+#error "F_CPU not defined"
+#endif
+
+void millis_init(void);
+uint32_t millis(void);
+
+// Recalibrate the time base on a clock switch (See clock_users.c)
+void millis_clock_apply(uint32_t hz);
+
+// Called from TIM4_UPD_OVF_IRQHandler (See stm8s_it.c)
+void millis_isr(void);
+
+#endif /* _MILLIS_H_INCLUDED_ */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Cooperative task scheduler built on top of millis()
+ * 
+ */
+
+#ifndef _SCHEDULER_H_INCLUDED_
+#define _SCHEDULER_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Max number of tasks that can be scheduled at once
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS 4
+#endif
+
+#define SCHED_NO_TASK -1
+
+typedef void (*task_fn)(void);
+
+// Runs fn after delay_ms, then every period_ms. A period of 0 runs fn only
+// once. Delays and periods are limited to 32767ms.
+// Returns the task id, or SCHED_NO_TASK if all task slots are taken.
+int8_t sched_add(task_fn fn, uint16_t delay_ms, uint16_t period_ms);
+void sched_remove(int8_t id);
+
+// Runs all due tasks, to be called from the main loop
+void sched_run(void);
+
+#endif /* _SCHEDULER_H_INCLUDED_ */
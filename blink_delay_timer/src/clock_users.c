@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Modules of the blink_delay_timer example that follow a
+ * 		clock switch (See clock.h)
+ *
+ * Only the TIM4 millisecond time base depends on the clock. It runs at any
+ * of the clocks, so it never refuses a switch.
+ */
+
+#include <stddef.h>
+
+#include <clock.h>
+#include <millis.h>
+
+const clock_user_t clock_users[] = {
+	{ NULL, millis_clock_apply },	// TIM4 time base
+};
+
+const uint8_t clock_users_count = sizeof(clock_users) / sizeof(clock_users[0]);
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Blinks the built-in LED using a TIM4 based millisecond
+ * 		time base and a cooperative task scheduler, leaving the CPU
+ * 		free (or asleep) between tasks.
+ * 
+ */
+
+// PlatformIO
+#include <stm8s.h>
+
+// include/
+#include <stm8s_it.h>
+#include <millis.h>
+#include <scheduler.h>
+#include <spurious.h>
+#include <clock.h>
+
+// HSI divider matching F_CPU, the CPU clock itself is not divided further
+#if F_CPU == 16000000UL
+#define CKDIVR_HSIDIV 0x00 // HSI/1
+#elif F_CPU == 8000000UL
+#define CKDIVR_HSIDIV 0x08 // HSI/2
+#elif F_CPU == 4000000UL
+#define CKDIVR_HSIDIV 0x10 // HSI/4
+#elif F_CPU == 2000000UL
+#define CKDIVR_HSIDIV 0x18 // HSI/8 (Reset default)
+#else
+#error F_CPU must be 16, 8, 4 or 2MHz! Please set the board_build.f_cpu option in the platformio.ini file accordingly!
+#endif
+
+// Built-in LED (Pin B5, Active Low)
+#define LED_BUILTIN_PORT GPIOB
+#define LED_BUILTIN_PIN  GPIO_PIN_5
+
+#define BLINK_SLOW_MS 1000	// Blink period after reset
+#define BLINK_FAST_MS 250	// Blink period once SPEEDUP_AFTER_MS has passed
+#define SPEEDUP_AFTER_MS 10000
+
+// Define CLOCK_DEMO to switch to the next clock source every
+// CLOCK_DEMO_MS (See clock.h). The blink periods must not change.
+#define CLOCK_DEMO_MS 3000
+
+static int8_t blink_task;
+
+static void blink(void)
+{
+	GPIO_WriteReverse(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Toggle built-in LED
+}
+
+static void speedup(void)
+{
+	sched_remove(blink_task);
+	blink_task = sched_add(blink, BLINK_FAST_MS, BLINK_FAST_MS);
+}
+
+#ifdef CLOCK_DEMO
+static void clock_demo(void)
+{
+	static clock_source_t source = CLOCK_HSI;
+
+	source = source == CLOCK_LSI ? CLOCK_HSI : (clock_source_t)(source + 1);
+	clock_switch(source); // Stays on the current clock if the HSE or LSI is not available
+}
+#endif
+
+void main(void)
+{
+	SPURIOUS_INIT(); // Check the spurious interrupt log that survived the reset (See spurious.h)
+
+	CLK->CKDIVR = CKDIVR_HSIDIV; // Run the CPU at F_CPU
+
+	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
+
+	millis_init();
+	enableInterrupts();
+
+	blink_task = sched_add(blink, BLINK_SLOW_MS, BLINK_SLOW_MS);	// Periodic task
+	sched_add(speedup, SPEEDUP_AFTER_MS, 0);			// One-shot task
+#ifdef CLOCK_DEMO
+	sched_add(clock_demo, CLOCK_DEMO_MS, CLOCK_DEMO_MS);		// Periodic task
+#endif
+
+	while(TRUE)
+	{
+		sched_run();
+		wfi(); // Sleep until the next millisecond tick
+	}
+}
+
+// See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
+#ifdef USE_FULL_ASSERT
+void assert_failed(uint8_t* file, uint32_t line)
+{ 
+	while (TRUE)
+	{
+	}
+}
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the TIM4 millisecond time base
+ * 
+ * TIM4 is an 8-bit timer with a power-of-two prescaler (1 to 128). To get
+ * an update interrupt every millisecond, we pick the smallest prescaler
+ * for which the number of timer ticks per millisecond fits into the 8-bit
+ * auto-reload register. All of this is resolved at compile time from F_CPU.
+ *
+ * After a clock switch (See clock.h), millis_clock_apply() repeats the same
+ * selection at runtime for the new clock. The counter keeps its value, so
+ * scheduled tasks stay due at the same time.
+ * 
+ */
+
+#include <millis.h>
+
+#define TICKS_PER_MS (F_CPU / 1000UL) // Timer input clock ticks per millisecond
+
+#if TICKS_PER_MS <= 256UL
+#define TIM4_DIV 1UL
+#define TIM4_PSC TIM4_PRESCALER_1
+#elif TICKS_PER_MS <= 2UL * 256UL
+#define TIM4_DIV 2UL
+#define TIM4_PSC TIM4_PRESCALER_2
+#elif TICKS_PER_MS <= 4UL * 256UL
+#define TIM4_DIV 4UL
+#define TIM4_PSC TIM4_PRESCALER_4
+#elif TICKS_PER_MS <= 8UL * 256UL
+#define TIM4_DIV 8UL
+#define TIM4_PSC TIM4_PRESCALER_8
+#elif TICKS_PER_MS <= 16UL * 256UL
+#define TIM4_DIV 16UL
+#define TIM4_PSC TIM4_PRESCALER_16
+#elif TICKS_PER_MS <= 32UL * 256UL
+#define TIM4_DIV 32UL
+#define TIM4_PSC TIM4_PRESCALER_32
+#elif TICKS_PER_MS <= 64UL * 256UL
+#define TIM4_DIV 64UL
+#define TIM4_PSC TIM4_PRESCALER_64
+#elif TICKS_PER_MS <= 128UL * 256UL
+#define TIM4_DIV 128UL
+#define TIM4_PSC TIM4_PRESCALER_128
+#else
+#error F_CPU too high for a 1ms TIM4 period!
+#endif
+
+#if TICKS_PER_MS % TIM4_DIV != 0
+#warning F_CPU is not a multiple of the TIM4 prescaler, millis() will drift!
+#endif
+
+#define TIM4_ARR (TICKS_PER_MS / TIM4_DIV - 1) // Timer counts from 0 to TIM4_ARR
+
+static volatile uint32_t _millis;
+
+void millis_init(void)
+{
+	_millis = 0;
+
+	TIM4_DeInit();
+	TIM4_TimeBaseInit(TIM4_PSC, TIM4_ARR);	// Overflow every millisecond
+	TIM4_ClearFlag(TIM4_FLAG_UPDATE);
+	TIM4_ITConfig(TIM4_IT_UPDATE, ENABLE);	// Raise TIM4_UPD_OVF_IRQHandler on overflow
+	TIM4_Cmd(ENABLE);
+}
+
+uint32_t millis(void)
+{
+	uint32_t ret;
+
+	// 32-bit counter is written by the ISR, read it twice to avoid a torn value
+	do {
+		ret = _millis;
+	} while (ret != _millis);
+
+	return ret;
+}
+
+void millis_clock_apply(uint32_t hz)
+{
+	uint32_t ticks = hz / 1000UL; // Timer input clock ticks per millisecond
+	uint8_t psc = 0;
+
+	while (psc < TIM4_PRESCALER_128 && ticks > (256UL << psc))
+		psc++;
+
+	TIM4->PSCR = psc;
+	TIM4->ARR = (uint8_t)((ticks >> psc) - 1);	// Truncated like TIM4_ARR, drifts if ticks is no multiple of 2^psc
+	TIM4->EGR = TIM4_EGR_UG;			// Load the prescaler now rather than at the next overflow
+	TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF);		// The forced update is not a millisecond
+}
+
+void millis_isr(void)
+{
+	TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF); // Clear update flag
+	_millis++;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the cooperative task scheduler
+ * 
+ * Tasks are kept in a fixed size table, so no memory is allocated at run
+ * time. Deadlines are stored as the lower 16 bits of millis() and compared
+ * through a signed difference, which keeps working across the counter
+ * wrapping around as long as no delay exceeds 32767ms. Periodic tasks
+ * advance their deadline by their period rather than rescheduling from the
+ * current time, so a late run does not make the following runs drift.
+ * 
+ */
+
+#include <stddef.h>
+
+#include <scheduler.h>
+#include <millis.h>
+
+typedef struct {
+	task_fn fn;		// NULL if the slot is free
+	uint16_t due;		// Lower 16 bits of millis() at which to run next
+	uint16_t period;	// 0 for one-shot tasks
+} task_t;
+
+static task_t _tasks[SCHED_MAX_TASKS];
+
+int8_t sched_add(task_fn fn, uint16_t delay_ms, uint16_t period_ms)
+{
+	int8_t i;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++) {
+		if (_tasks[i].fn == NULL) {
+			_tasks[i].due = (uint16_t)millis() + delay_ms;
+			_tasks[i].period = period_ms;
+			_tasks[i].fn = fn;
+			return i;
+		}
+	}
+
+	return SCHED_NO_TASK;
+}
+
+void sched_remove(int8_t id)
+{
+	if (id >= 0 && id < SCHED_MAX_TASKS)
+		_tasks[id].fn = NULL;
+}
+
+void sched_run(void)
+{
+	uint8_t i;
+	uint16_t now = (uint16_t)millis();
+	task_fn fn;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++) {
+		fn = _tasks[i].fn;
+
+		if (fn == NULL || (int16_t)(now - _tasks[i].due) < 0)
+			continue;
+
+		if (_tasks[i].period)
+			_tasks[i].due += _tasks[i].period;	// Next run, relative to the last deadline
+		else
+			_tasks[i].fn = NULL;			// One-shot, free the slot before running
+
+		fn(); // May add or remove tasks
+	}
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Markers for the ucsim benchmark harness (See bench/ in the
+ * 		repository root). Each region is bracketed by BENCH_BEGIN and
+ * 		BENCH_END, which place the global labels bench_<name>_begin
+ * 		and bench_<name>_end in the firmware. The harness sets
+ * 		breakpoints on them and reports the cycles between the two.
+ *
+ * 		The markers only exist if BENCH is defined. They emit no
+ * 		instructions, but as inline assembly, they keep SDCC from
+ * 		moving code across them.
+ */
+
+#ifndef _BENCH_H_INCLUDED_
+#define _BENCH_H_INCLUDED_
+
+#ifdef BENCH
+#define BENCH_BEGIN(name) __asm__("bench_" #name "_begin::")
+#define BENCH_END(name)   __asm__("bench_" #name "_end::")
+#else
+#define BENCH_BEGIN(name)
+#define BENCH_END(name)
+#endif
+
+#endif /* _BENCH_H_INCLUDED_ */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Runtime clock switching
+ * 		Switches the master clock between the HSI and its dividers,
+ * 		the HSE and the LSI. Every module whose timing is derived
+ * 		from the clock registers itself in the project's clock_users
+ * 		table (See src/clock_users.c) and is recalibrated on each switch.
+ * 		The CPU clock divider is left at 1, so fCPU = fMASTER.
+ */
+
+#ifndef _CLOCK_H_INCLUDED_
+#define _CLOCK_H_INCLUDED_
+
+#include <stm8s.h>
+
+typedef enum {
+	CLOCK_HSI,	// 16MHz internal RC
+	CLOCK_HSI_DIV2,	// 8MHz
+	CLOCK_HSI_DIV4,	// 4MHz
+	CLOCK_HSI_DIV8,	// 2MHz, reset default
+	CLOCK_HSE,	// Crystal or external clock at HSE_VALUE, not fitted on the blue board
+	CLOCK_LSI	// 128kHz internal RC, only selectable if the LSI_EN option byte is set
+} clock_source_t;
+
+typedef struct {
+	// Called with the new frequency before the switch. Returns FALSE if
+	// the module cannot run at it, which cancels the switch. May be NULL.
+	bool (*prepare)(uint32_t hz);
+	// Called with the new frequency once the clock has switched
+	void (*apply)(uint32_t hz);
+} clock_user_t;
+
+// Defined per project (See clock_users.c)
+extern const clock_user_t clock_users[];
+extern const uint8_t clock_users_count;
+
+// Returns FALSE and keeps the current clock if a user refused the new
+// frequency or the new source did not become ready. Interrupts are
+// disabled during the switch, so no handler runs with the timing of the
+// old clock, and the interrupt mask found on entry is restored before
+// returning (See critical.h).
+bool clock_switch(clock_source_t source);
+
+// Current fMASTER (= fCPU) in Hz
+uint32_t clock_hz(void);
+
+#endif /* _CLOCK_H_INCLUDED_ */
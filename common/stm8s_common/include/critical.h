@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Critical sections that restore the interrupt mask they
+ * 		found, instead of unconditionally enabling interrupts
+ */
+
+#ifndef _CRITICAL_H_INCLUDED_
+#define _CRITICAL_H_INCLUDED_
+
+#include <stm8s.h>
+
+// disableInterrupts() followed by enableInterrupts() is only right where
+// interrupts are known to be enabled. Called from a handler, or from code
+// that already runs with interrupts disabled, the enableInterrupts()
+// clears I1 and I0 and lets everything in, including handlers of the
+// same priority. critical_enter() saves CC before setting the mask with
+// sim, and critical_exit() puts the saved I1 and I0 back with pop cc:
+//
+//	critical_t cc = critical_enter();
+//	...
+//	critical_exit(cc);
+//
+// Each is estimated at about a dozen cycles, including the call and ret,
+// counted from the instruction tables of PM0044, not measured.
+
+typedef uint8_t critical_t;
+
+critical_t critical_enter(void);
+void critical_exit(critical_t cc);
+
+#endif /* _CRITICAL_H_INCLUDED_ */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Header-only GPIO layer with direct register access
+ * 		The port and pin of every operation must be compile-time
+ * 		constants, e.g. GPIOB and GPIO_PIN_5. SDCC then turns each
+ * 		write into a single bset/bres/bcpl instruction on the port
+ * 		register and each read into a btjt/btjf, instead of a call
+ * 		into the SPL GPIO module.
+ *
+ * 		Build with -D GPIO_FAST=0 to map the same macros onto the
+ * 		SPL functions, e.g. to compare flash size and cycle counts.
+ */
+
+#ifndef _GPIO_FAST_H_INCLUDED_
+#define _GPIO_FAST_H_INCLUDED_
+
+#include <stm8s.h>
+
+#ifndef GPIO_FAST
+#define GPIO_FAST 1
+#endif
+
+#if GPIO_FAST
+
+// Same arguments and behaviour as GPIO_Init(). Since mode is a constant,
+// the compiler folds the conditions and only the bit instructions remain.
+// The bits of GPIO_Mode_TypeDef are: 0x80 DDR, 0x40 CR1, 0x20 CR2, 0x10 ODR.
+#define GPIO_INIT(port, pin, mode) do {						\
+	(port)->CR2 &= (uint8_t)(~(pin));	/* No interrupt/slope change while reconfiguring */ \
+	if ((mode) & 0x80) {							\
+		if ((mode) & 0x10)						\
+			(port)->ODR |= (uint8_t)(pin);				\
+		else								\
+			(port)->ODR &= (uint8_t)(~(pin));			\
+		(port)->DDR |= (uint8_t)(pin);					\
+	} else {								\
+		(port)->DDR &= (uint8_t)(~(pin));				\
+	}									\
+	if ((mode) & 0x40)							\
+		(port)->CR1 |= (uint8_t)(pin);					\
+	else									\
+		(port)->CR1 &= (uint8_t)(~(pin));				\
+	if ((mode) & 0x20)							\
+		(port)->CR2 |= (uint8_t)(pin);					\
+} while (0)
+
+#define GPIO_HIGH(port, pin)	((port)->ODR |= (uint8_t)(pin))		// bset
+#define GPIO_LOW(port, pin)	((port)->ODR &= (uint8_t)(~(pin)))	// bres
+#define GPIO_TOGGLE(port, pin)	((port)->ODR ^= (uint8_t)(pin))		// bcpl
+#define GPIO_READ(port, pin)	((port)->IDR & (uint8_t)(pin))		// btjt/btjf when used as a condition
+
+#else
+
+#define GPIO_INIT(port, pin, mode)	GPIO_Init(port, pin, mode)
+#define GPIO_HIGH(port, pin)		GPIO_WriteHigh(port, pin)
+#define GPIO_LOW(port, pin)		GPIO_WriteLow(port, pin)
+#define GPIO_TOGGLE(port, pin)		GPIO_WriteReverse(port, pin)
+#define GPIO_READ(port, pin)		GPIO_ReadInputPin(port, pin)
+
+#endif /* GPIO_FAST */
+
+#endif /* _GPIO_FAST_H_INCLUDED_ */
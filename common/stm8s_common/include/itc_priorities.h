@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Software priorities of the interrupts used by an example
+ *
+ * 		After reset, every vector runs at software priority level 3,
+ * 		so handlers never interrupt each other and a slow handler
+ * 		delays every other pending interrupt until it returns. Once
+ * 		a vector is set to a lower level, handlers of a higher level
+ * 		pre-empt it (See nested interrupt mode in the ITC chapter
+ * 		of RM0016). The table in src/itc_priorities.c of the
+ * 		example lists the level of each vector, vectors it does
+ * 		not list stay at level 3.
+ */
+
+#ifndef _ITC_PRIORITIES_H_INCLUDED_
+#define _ITC_PRIORITIES_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Set to 0 to leave all vectors at their reset level, ex. to compare
+// interrupt latencies with and without the table
+#ifndef ITC_PRIORITIES
+#define ITC_PRIORITIES 1
+#endif
+
+typedef struct {
+	ITC_Irq_TypeDef irq;
+	ITC_PriorityLevel_TypeDef level;	// ITC_PRIORITYLEVEL_1 (lowest) to ITC_PRIORITYLEVEL_3 (highest)
+} itc_priority_t;
+
+// Writes the table to ITC_SPRx. The registers can only be written while
+// interrupts are disabled, so call this before enableInterrupts().
+void itc_priorities_init(void);
+
+#endif /* _ITC_PRIORITIES_H_INCLUDED_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Logging of spurious interrupts, ie. interrupts of vectors
+ * 		an example does not use. Every unused handler in the
+ * 		example's stm8s_it.c calls SPURIOUS_ISR() with its vector
+ * 		number.
+ */
+
+#ifndef _SPURIOUS_H_INCLUDED_
+#define _SPURIOUS_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Set to 0 to turn the unused handlers back into empty stubs
+#ifndef SPURIOUS_LOG
+#define SPURIOUS_LOG 1
+#endif
+
+// Once a vector has fired this many times, the interrupt enable bits of its
+// peripheral are cleared, so a source that is never acknowledged cannot
+// keep re-entering its handler and starve the main loop. 0 never masks.
+#ifndef SPURIOUS_MASK_AFTER
+#define SPURIOUS_MASK_AFTER 0
+#endif
+
+#if SPURIOUS_MASK_AFTER > 255
+#error SPURIOUS_MASK_AFTER must not exceed 255, the per vector counters saturate there!
+#endif
+
+// The log lives at a fixed RAM address that the startup code does not
+// clear, so it survives a reset and can be read after a watchdog or
+// manual reset. By default it sits right below the upper 256 bytes of
+// RAM, which are left to the stack (RAM ends at 0x3FF on the STM8S103).
+#ifndef SPURIOUS_LOG_ADDR
+#define SPURIOUS_LOG_ADDR 0x02E0
+#endif
+
+#define SPURIOUS_MAGIC   0x5350	// "SP", marks a valid log
+#define SPURIOUS_VECTORS 26	// IRQ0 to IRQ24, and the TRAP instruction
+#define SPURIOUS_TRAP    25	// Index of the TRAP handler
+
+typedef struct {
+	uint16_t magic;				// SPURIOUS_MAGIC once the log is valid
+	uint16_t total;				// Spurious interrupts logged, saturates
+	uint8_t last;				// Vector of the most recent one
+	uint8_t resets;				// Resets the log has survived, saturates
+	uint8_t hits[SPURIOUS_VECTORS];		// Per vector, saturates at 255
+} spurious_log_t;
+
+#if SPURIOUS_LOG
+extern volatile spurious_log_t spurious_log;
+
+void spurious_init(void);		// Validates the log after a reset, call first thing in main()
+void spurious_clear(void);
+void spurious_isr(uint8_t vector);	// Called from the unused handlers (See stm8s_it.c)
+
+#define SPURIOUS_INIT()		spurious_init()
+#define SPURIOUS_ISR(vector)	spurious_isr(vector)
+#else
+#define SPURIOUS_INIT()
+#define SPURIOUS_ISR(vector)
+#endif
+
+#endif /* _SPURIOUS_H_INCLUDED_ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Implementation of the runtime clock switching
+ *
+ * The switch runs in automatic mode: the clock controller starts the new
+ * source and only switches once it is stable. A source that never becomes
+ * ready, like the HSE without a crystal or the LSI without the LSI_EN
+ * option byte, lets CLK_ClockSwitchConfig() time out, after which the
+ * pending switch is aborted and the CPU keeps running on the old clock
+ * (See the clock switching procedure in the clock control chapter of
+ * RM0016). The old source is turned off after a successful switch to
+ * save power.
+ */
+
+#include <clock.h>
+#include <critical.h>
+
+// HSI divider of CLOCK_HSI to CLOCK_HSI_DIV8
+static const CLK_Prescaler_TypeDef _hsidiv[] = {
+	CLK_PRESCALER_HSIDIV1,
+	CLK_PRESCALER_HSIDIV2,
+	CLK_PRESCALER_HSIDIV4,
+	CLK_PRESCALER_HSIDIV8
+};
+
+static uint32_t _source_hz(clock_source_t source)
+{
+	if (source <= CLOCK_HSI_DIV8)
+		return HSI_VALUE >> source;
+	if (source == CLOCK_HSE)
+		return HSE_VALUE;
+	return LSI_VALUE;
+}
+
+bool clock_switch(clock_source_t source)
+{
+	uint32_t hz = _source_hz(source);
+	CLK_Source_TypeDef master;
+	uint8_t i;
+	critical_t cc = critical_enter(); // Callers that already run with interrupts disabled keep them so
+
+	for (i = 0; i < clock_users_count; i++) {
+		if (clock_users[i].prepare && !clock_users[i].prepare(hz)) {
+			critical_exit(cc);
+			return FALSE;
+		}
+	}
+
+	if (source <= CLOCK_HSI_DIV8) {
+		master = CLK_SOURCE_HSI;
+		CLK_HSIPrescalerConfig(_hsidiv[source]); // Only divides the HSI, takes effect at once if it is running
+	} else if (source == CLOCK_HSE) {
+		master = CLK_SOURCE_HSE;
+	} else {
+		master = CLK_SOURCE_LSI;
+	}
+
+	if (CLK->CMSR != master &&
+	    CLK_ClockSwitchConfig(CLK_SWITCHMODE_AUTO, master, DISABLE, CLK_CURRENTCLOCKSTATE_DISABLE) == ERROR) {
+		CLK->SWCR &= (uint8_t)(~(CLK_SWCR_SWEN | CLK_SWCR_SWBSY)); // Abort the pending switch
+		critical_exit(cc);
+		return FALSE;
+	}
+
+	for (i = 0; i < clock_users_count; i++)
+		clock_users[i].apply(hz);
+
+	critical_exit(cc);
+	return TRUE;
+}
+
+uint32_t clock_hz(void)
+{
+	return CLK_GetClockFreq();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the critical sections
+ */
+
+#include <critical.h>
+
+#ifdef __SDCC
+
+// Both functions are __naked, so SDCC emits neither prologue nor ret.
+// CC cannot be read or written directly, only through push cc and pop cc.
+// Doing that inline in a C function would move sp under the locals SDCC
+// addresses relative to it, so it is done here instead. An 8 bit value is
+// returned in a, the argument arrives in a for __sdcccall(1) (default
+// since SDCC 4.2), or on the stack above the return address for
+// __sdcccall(0).
+
+critical_t critical_enter(void) __naked {
+	__asm
+		push cc			// 1 cycle
+		pop a			// Return CC as found: 1 cycle
+		sim			// Mask interrupts: 1 cycle
+		ret			// 4 cycles
+	__endasm;
+}
+
+void critical_exit(critical_t cc) __naked {
+	(void) cc;
+	__asm
+#if !defined(__SDCCCALL) || __SDCCCALL == 0
+		ld a, (3, sp)		// Load cc argument from stack: 1 cycle
+#endif
+		push a			// 1 cycle
+		pop cc			// Restores I1 and I0 along with the flags: 1 cycle
+		ret			// 4 cycles
+	__endasm;
+}
+
+#else // Host build (See host/README.md), the mask is a single flag there
+
+critical_t critical_enter(void)
+{
+	critical_t cc = host_interrupts_enabled;
+
+	disableInterrupts();
+	return cc;
+}
+
+void critical_exit(critical_t cc)
+{
+	if (cc)
+		enableInterrupts(); // Runs what was raised meanwhile, like the real rim
+}
+
+#endif
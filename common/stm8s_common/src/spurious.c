@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the spurious interrupt log
+ *
+ * SDCC's startup code only clears the variables of the DATA area. An
+ * absolute (__at) variable without initializer lives outside of it, so
+ * its content is left as is by a reset. After power-up the RAM holds
+ * random values instead, which is told apart by the magic number.
+ *
+ * Build with -D SPURIOUS_SELFTEST to have spurious_init() enable the TIM2
+ * update interrupt, whose handler is one of the unused ones. Since it
+ * never clears the update flag, the handler is re-entered until the log
+ * saturates, or until it is masked after SPURIOUS_MASK_AFTER hits.
+ */
+
+#include <spurious.h>
+
+// Only built if SPURIOUS_LOG is set, SDCC does not drop unused functions
+#if SPURIOUS_LOG
+
+#ifdef __SDCC
+__at(SPURIOUS_LOG_ADDR) volatile spurious_log_t spurious_log;
+#else
+volatile spurious_log_t spurious_log; // Host build (See host/README.md)
+#endif
+
+void spurious_clear(void)
+{
+	uint8_t i;
+
+	spurious_log.total = 0;
+	spurious_log.last = 0;
+	spurious_log.resets = 0;
+	for (i = 0; i < SPURIOUS_VECTORS; i++)
+		spurious_log.hits[i] = 0;
+	spurious_log.magic = SPURIOUS_MAGIC;
+}
+
+void spurious_init(void)
+{
+	if (spurious_log.magic != SPURIOUS_MAGIC)
+		spurious_clear(); // Power-up, RAM content is random
+	else if (spurious_log.resets != 0xFF)
+		spurious_log.resets++;
+
+#ifdef SPURIOUS_SELFTEST
+	TIM2->PSCR = 0;
+	TIM2->ARRH = 0x01;		// Overflow every 256 cycles
+	TIM2->ARRL = 0x00;
+	TIM2->IER |= TIM2_IER_UIE;
+	TIM2->CR1 |= TIM2_CR1_CEN;
+#endif
+}
+
+#if SPURIOUS_MASK_AFTER
+// Clears the interrupt enable bits of the peripheral behind a vector
+static void mask_source(uint8_t vector)
+{
+	switch (vector) {
+	case 0:  GPIOD->CR2 &= (uint8_t)(GPIOD->DDR | 0x7F); break;		// TLI on PD7, CR2 of outputs sets their speed
+	case 1:  AWU->CSR &= (uint8_t)(~AWU_CSR_AWUEN); break;
+	case 2:  CLK->SWCR &= (uint8_t)(~CLK_SWCR_SWIEN);
+		 CLK->CSSR &= (uint8_t)(~CLK_CSSR_CSSDIE); break;
+	case 3:  GPIOA->CR2 &= GPIOA->DDR; break;				// Input pins of the port
+	case 4:  GPIOB->CR2 &= GPIOB->DDR; break;
+	case 5:  GPIOC->CR2 &= GPIOC->DDR; break;
+	case 6:  GPIOD->CR2 &= GPIOD->DDR; break;
+	case 7:  GPIOE->CR2 &= GPIOE->DDR; break;
+	case 10: SPI->ICR = 0; break;
+	case 11:
+	case 12: TIM1->IER = 0; break;
+	case 13:
+	case 14: TIM2->IER = 0; break;
+	case 17: UART1->CR2 &= (uint8_t)(~(UART1_CR2_TIEN | UART1_CR2_TCIEN)); break;
+	case 18: UART1->CR2 &= (uint8_t)(~(UART1_CR2_RIEN | UART1_CR2_ILIEN)); break;
+	case 19: I2C->ITR = 0; break;
+	case 22: ADC1->CSR &= (uint8_t)(~(ADC1_CSR_EOCIE | ADC1_CSR_AWDIE)); break;
+	case 23: TIM4->IER = 0; break;
+	case 24: FLASH->CR1 &= (uint8_t)(~FLASH_CR1_IE); break;
+	default: break;								// TRAP cannot be masked
+	}
+}
+#endif
+
+void spurious_isr(uint8_t vector)
+{
+	spurious_log.last = vector;
+	if (spurious_log.total != 0xFFFF)
+		spurious_log.total++;
+
+	if (spurious_log.hits[vector] != 0xFF)
+		spurious_log.hits[vector]++;
+
+#if SPURIOUS_MASK_AFTER
+	if (spurious_log.hits[vector] >= SPURIOUS_MASK_AFTER)
+		mask_source(vector);
+#endif
+}
+
+#endif /* SPURIOUS_LOG */
@@ -0,0 +1,764 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Host replacement for the SPL's stm8s.h
+ * 		Lets the example sources compile with gcc/clang on Linux.
+ * 		Every peripheral register block is a plain struct in host
+ * 		memory with the same layout and bit definitions as on the
+ * 		STM8S103, so code that accesses registers directly works
+ * 		unchanged. The SPL functions used by the examples are
+ * 		implemented at register level in stm8s_host.c.
+ *
+ * 		Interrupts are modelled as plain function calls: the host_*
+ * 		functions below change the peripheral state the way the
+ * 		hardware would, and call the matching handler of stm8s_it.c
+ * 		if its interrupt is enabled, or once interrupts are enabled
+ * 		again. wfi() and halt() call host_idle_hook, which is where
+ * 		a test advances the simulated world.
+ *
+ * 		Only built for the native environment (See library.json).
+ */
+
+#ifndef _STM8S_HOST_H_INCLUDED_
+#define _STM8S_HOST_H_INCLUDED_
+
+#include <stdint.h>
+
+#ifndef STM8S103
+#define STM8S103
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+
+#define __IO volatile
+
+typedef enum {FALSE = 0, TRUE = !FALSE} bool;
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus, BitStatus, BitAction;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrorStatus;
+
+#define assert_param(expr) ((void)0)
+
+/* CPU -----------------------------------------------------------------------*/
+
+// Handlers are regular functions on the host
+#define INTERRUPT
+#define INTERRUPT_HANDLER(a, b) void a(void)
+#define INTERRUPT_HANDLER_TRAP(a) void a(void)
+
+#define enableInterrupts()	host_enable_interrupts()
+#define disableInterrupts()	(host_interrupts_enabled = FALSE)
+#define rim()			enableInterrupts()
+#define sim()			disableInterrupts()
+#define nop()			((void)0)
+#define trap()			TRAP_IRQHandler()
+#define wfi()			host_idle(FALSE)	// Enables interrupts, like the real instruction
+#define halt()			host_idle(TRUE)
+
+/* Registers -----------------------------------------------------------------*/
+
+typedef struct {
+	__IO uint8_t ODR;
+	__IO uint8_t IDR;
+	__IO uint8_t DDR;
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+} GPIO_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+} EXTI_TypeDef;
+
+typedef struct {
+	__IO uint8_t ISPR1;
+	__IO uint8_t ISPR2;
+	__IO uint8_t ISPR3;
+	__IO uint8_t ISPR4;
+	__IO uint8_t ISPR5;
+	__IO uint8_t ISPR6;
+	__IO uint8_t ISPR7;
+	__IO uint8_t ISPR8;
+} ITC_TypeDef;
+
+typedef struct {
+	__IO uint8_t ICKR;
+	__IO uint8_t ECKR;
+	uint8_t RESERVED;
+	__IO uint8_t CMSR;
+	__IO uint8_t SWR;
+	__IO uint8_t SWCR;
+	__IO uint8_t CKDIVR;
+	__IO uint8_t PCKENR1;
+	__IO uint8_t CSSR;
+	__IO uint8_t CCOR;
+	__IO uint8_t PCKENR2;
+	uint8_t RESERVED1;
+	__IO uint8_t HSITRIMR;
+	__IO uint8_t SWIMCCR;
+} CLK_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t NCR2;
+	__IO uint8_t FPR;
+	__IO uint8_t NFPR;
+	__IO uint8_t IAPSR;
+	uint8_t RESERVED1;
+	uint8_t RESERVED2;
+	__IO uint8_t PUKR;
+	uint8_t RESERVED3;
+	__IO uint8_t DUKR;
+} FLASH_TypeDef;
+
+typedef struct {
+	__IO uint8_t CSR;
+	__IO uint8_t APR;
+	__IO uint8_t TBR;
+} AWU_TypeDef;
+
+typedef struct {
+	__IO uint8_t DB0RH, DB0RL, DB1RH, DB1RL, DB2RH, DB2RL, DB3RH, DB3RL, DB4RH, DB4RL;
+	__IO uint8_t DB5RH, DB5RL, DB6RH, DB6RL, DB7RH, DB7RL, DB8RH, DB8RL, DB9RH, DB9RL;
+	uint8_t RESERVED[12];
+	__IO uint8_t CSR;
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t CR3;
+	__IO uint8_t DRH;
+	__IO uint8_t DRL;
+	__IO uint8_t TDRH;
+	__IO uint8_t TDRL;
+	__IO uint8_t HTRH;
+	__IO uint8_t HTRL;
+	__IO uint8_t LTRH;
+	__IO uint8_t LTRL;
+	__IO uint8_t AWSRH;
+	__IO uint8_t AWSRL;
+	__IO uint8_t AWCRH;
+	__IO uint8_t AWCRL;
+} ADC1_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t SMCR;
+	__IO uint8_t ETR;
+	__IO uint8_t IER;
+	__IO uint8_t SR1;
+	__IO uint8_t SR2;
+	__IO uint8_t EGR;
+	__IO uint8_t CCMR1;
+	__IO uint8_t CCMR2;
+	__IO uint8_t CCMR3;
+	__IO uint8_t CCMR4;
+	__IO uint8_t CCER1;
+	__IO uint8_t CCER2;
+	__IO uint8_t CNTRH;
+	__IO uint8_t CNTRL;
+	__IO uint8_t PSCRH;
+	__IO uint8_t PSCRL;
+	__IO uint8_t ARRH;
+	__IO uint8_t ARRL;
+	__IO uint8_t RCR;
+	__IO uint8_t CCR1H, CCR1L, CCR2H, CCR2L, CCR3H, CCR3L, CCR4H, CCR4L;
+	__IO uint8_t BKR;
+	__IO uint8_t DTR;
+	__IO uint8_t OISR;
+} TIM1_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	uint8_t RESERVED1;
+	uint8_t RESERVED2;
+	__IO uint8_t IER;
+	__IO uint8_t SR1;
+	__IO uint8_t SR2;
+	__IO uint8_t EGR;
+	__IO uint8_t CCMR1;
+	__IO uint8_t CCMR2;
+	__IO uint8_t CCMR3;
+	__IO uint8_t CCER1;
+	__IO uint8_t CCER2;
+	__IO uint8_t CNTRH;
+	__IO uint8_t CNTRL;
+	__IO uint8_t PSCR;
+	__IO uint8_t ARRH;
+	__IO uint8_t ARRL;
+	__IO uint8_t CCR1H, CCR1L, CCR2H, CCR2L, CCR3H, CCR3L;
+} TIM2_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	uint8_t RESERVED1;
+	uint8_t RESERVED2;
+	__IO uint8_t IER;
+	__IO uint8_t SR1;
+	__IO uint8_t EGR;
+	__IO uint8_t CNTR;
+	__IO uint8_t PSCR;
+	__IO uint8_t ARR;
+} TIM4_TypeDef;
+
+typedef struct {
+	__IO uint8_t SR;
+	__IO uint8_t DR;
+	__IO uint8_t BRR1;
+	__IO uint8_t BRR2;
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t CR3;
+	__IO uint8_t CR4;
+	__IO uint8_t CR5;
+	__IO uint8_t GTR;
+	__IO uint8_t PSCR;
+} UART1_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t ICR;
+	__IO uint8_t SR;
+	__IO uint8_t DR;
+	__IO uint8_t CRCPR;
+	__IO uint8_t RXCRCR;
+	__IO uint8_t TXCRCR;
+} SPI_TypeDef;
+
+typedef struct {
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t FREQR;
+	__IO uint8_t OARL;
+	__IO uint8_t OARH;
+	uint8_t RESERVED1;
+	__IO uint8_t DR;
+	__IO uint8_t SR1;
+	__IO uint8_t SR2;
+	__IO uint8_t SR3;
+	__IO uint8_t ITR;
+	__IO uint8_t CCRL;
+	__IO uint8_t CCRH;
+	__IO uint8_t TRISER;
+	uint8_t RESERVED2;
+} I2C_TypeDef;
+
+typedef struct {
+	ADC1_TypeDef ADC1 __attribute__((aligned(2)));	// Data buffer is read as uint16_t (See adc_scan.c)
+	GPIO_TypeDef GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF;
+	EXTI_TypeDef EXTI;
+	ITC_TypeDef ITC;
+	CLK_TypeDef CLK;
+	FLASH_TypeDef FLASH;
+	AWU_TypeDef AWU;
+	TIM1_TypeDef TIM1;
+	TIM2_TypeDef TIM2;
+	TIM4_TypeDef TIM4;
+	UART1_TypeDef UART1;
+	SPI_TypeDef SPI;
+	I2C_TypeDef I2C;
+} host_regs_t;
+
+extern host_regs_t host_regs; // All registers, reset by host_reset()
+
+#define GPIOA	(&host_regs.GPIOA)
+#define GPIOB	(&host_regs.GPIOB)
+#define GPIOC	(&host_regs.GPIOC)
+#define GPIOD	(&host_regs.GPIOD)
+#define GPIOE	(&host_regs.GPIOE)
+#define GPIOF	(&host_regs.GPIOF)
+#define EXTI	(&host_regs.EXTI)
+#define ITC	(&host_regs.ITC)
+#define CLK	(&host_regs.CLK)
+#define FLASH	(&host_regs.FLASH)
+#define AWU	(&host_regs.AWU)
+#define ADC1	(&host_regs.ADC1)
+#define TIM1	(&host_regs.TIM1)
+#define TIM2	(&host_regs.TIM2)
+#define TIM4	(&host_regs.TIM4)
+#define UART1	(&host_regs.UART1)
+#define SPI	(&host_regs.SPI)
+#define I2C	(&host_regs.I2C)
+
+/* Register bits -------------------------------------------------------------*/
+
+#define CLK_ICKR_REGAH		((uint8_t)0x20)
+#define CLK_ICKR_LSIRDY		((uint8_t)0x10)
+#define CLK_ICKR_LSIEN		((uint8_t)0x08)
+#define CLK_ICKR_FHWU		((uint8_t)0x04)
+#define CLK_ICKR_HSIRDY		((uint8_t)0x02)
+#define CLK_ICKR_HSIEN		((uint8_t)0x01)
+#define CLK_ECKR_HSERDY		((uint8_t)0x02)
+#define CLK_ECKR_HSEEN		((uint8_t)0x01)
+#define CLK_SWCR_SWIF		((uint8_t)0x08)
+#define CLK_SWCR_SWIEN		((uint8_t)0x04)
+#define CLK_SWCR_SWEN		((uint8_t)0x02)
+#define CLK_SWCR_SWBSY		((uint8_t)0x01)
+#define CLK_CKDIVR_HSIDIV	((uint8_t)0x18)
+#define CLK_CKDIVR_CPUDIV	((uint8_t)0x07)
+#define CLK_CSSR_CSSDIE		((uint8_t)0x04)
+
+#define FLASH_CR1_HALT		((uint8_t)0x08)
+#define FLASH_CR1_AHALT		((uint8_t)0x04)
+#define FLASH_CR1_IE		((uint8_t)0x02)
+#define FLASH_CR1_FIX		((uint8_t)0x01)
+
+#define AWU_CSR_AWUF		((uint8_t)0x20)
+#define AWU_CSR_AWUEN		((uint8_t)0x10)
+#define AWU_CSR_MSR		((uint8_t)0x01)
+
+#define ADC1_CSR_EOC		((uint8_t)0x80)
+#define ADC1_CSR_AWD		((uint8_t)0x40)
+#define ADC1_CSR_EOCIE		((uint8_t)0x20)
+#define ADC1_CSR_AWDIE		((uint8_t)0x10)
+#define ADC1_CSR_CH		((uint8_t)0x0F)
+#define ADC1_CR1_SPSEL		((uint8_t)0x70)
+#define ADC1_CR1_CONT		((uint8_t)0x02)
+#define ADC1_CR1_ADON		((uint8_t)0x01)
+#define ADC1_CR2_EXTTRIG	((uint8_t)0x40)
+#define ADC1_CR2_EXTSEL		((uint8_t)0x30)
+#define ADC1_CR2_ALIGN		((uint8_t)0x08)
+#define ADC1_CR2_SCAN		((uint8_t)0x02)
+#define ADC1_CR3_DBUF		((uint8_t)0x80)
+#define ADC1_CR3_OVR		((uint8_t)0x40)
+
+#define TIM1_CR1_CEN		((uint8_t)0x01)
+#define TIM1_CR2_MMS		((uint8_t)0x70)
+#define TIM1_IER_UIE		((uint8_t)0x01)
+#define TIM1_SR1_UIF		((uint8_t)0x01)
+#define TIM1_EGR_UG		((uint8_t)0x01)
+
+#define TIM2_CR1_ARPE		((uint8_t)0x80)
+#define TIM2_CR1_OPM		((uint8_t)0x08)
+#define TIM2_CR1_CEN		((uint8_t)0x01)
+#define TIM2_IER_UIE		((uint8_t)0x01)
+#define TIM2_SR1_UIF		((uint8_t)0x01)
+#define TIM2_EGR_UG		((uint8_t)0x01)
+#define TIM2_CCMR_OCM		((uint8_t)0x70)
+#define TIM2_CCMR_OCxPE		((uint8_t)0x08)
+#define TIM2_CCER1_CC1P		((uint8_t)0x02)
+#define TIM2_CCER1_CC1E		((uint8_t)0x01)
+
+#define TIM4_CR1_ARPE		((uint8_t)0x80)
+#define TIM4_CR1_OPM		((uint8_t)0x08)
+#define TIM4_CR1_URS		((uint8_t)0x04)
+#define TIM4_CR1_UDIS		((uint8_t)0x02)
+#define TIM4_CR1_CEN		((uint8_t)0x01)
+#define TIM4_IER_UIE		((uint8_t)0x01)
+#define TIM4_SR1_UIF		((uint8_t)0x01)
+#define TIM4_EGR_UG		((uint8_t)0x01)
+#define TIM4_PSCR_PSC		((uint8_t)0x07)
+
+#define UART1_SR_TXE		((uint8_t)0x80)
+#define UART1_SR_TC		((uint8_t)0x40)
+#define UART1_SR_RXNE		((uint8_t)0x20)
+#define UART1_SR_IDLE		((uint8_t)0x10)
+#define UART1_SR_OR		((uint8_t)0x08)
+#define UART1_SR_NF		((uint8_t)0x04)
+#define UART1_SR_FE		((uint8_t)0x02)
+#define UART1_SR_PE		((uint8_t)0x01)
+#define UART1_CR2_TIEN		((uint8_t)0x80)
+#define UART1_CR2_TCIEN		((uint8_t)0x40)
+#define UART1_CR2_RIEN		((uint8_t)0x20)
+#define UART1_CR2_ILIEN		((uint8_t)0x10)
+#define UART1_CR2_TEN		((uint8_t)0x08)
+#define UART1_CR2_REN		((uint8_t)0x04)
+#define UART1_CR2_RWU		((uint8_t)0x02)
+#define UART1_CR2_SBK		((uint8_t)0x01)
+
+/* SPL: CLK ------------------------------------------------------------------*/
+
+#define HSI_VALUE ((uint32_t)16000000)	// Internal RC
+#define LSI_VALUE ((uint32_t)128000)	// Internal low speed RC
+#ifndef HSE_VALUE
+#define HSE_VALUE ((uint32_t)16000000)	// External crystal, same default as the SPL
+#endif
+
+typedef enum {
+	CLK_SWITCHMODE_MANUAL = (uint8_t)0x00,
+	CLK_SWITCHMODE_AUTO   = (uint8_t)0x01
+} CLK_SwitchMode_TypeDef;
+
+typedef enum {
+	CLK_CURRENTCLOCKSTATE_DISABLE = (uint8_t)0x00,
+	CLK_CURRENTCLOCKSTATE_ENABLE  = (uint8_t)0x01
+} CLK_CurrentClockState_TypeDef;
+
+typedef enum {
+	CLK_SOURCE_HSI = (uint8_t)0xE1,
+	CLK_SOURCE_LSI = (uint8_t)0xD2,
+	CLK_SOURCE_HSE = (uint8_t)0xB4
+} CLK_Source_TypeDef;
+
+typedef enum {
+	CLK_PRESCALER_HSIDIV1 = (uint8_t)0x00,
+	CLK_PRESCALER_HSIDIV2 = (uint8_t)0x08,
+	CLK_PRESCALER_HSIDIV4 = (uint8_t)0x10,
+	CLK_PRESCALER_HSIDIV8 = (uint8_t)0x18
+} CLK_Prescaler_TypeDef;
+
+void CLK_HSIPrescalerConfig(CLK_Prescaler_TypeDef HSIPrescaler);
+ErrorStatus CLK_ClockSwitchConfig(CLK_SwitchMode_TypeDef CLK_SwitchMode, CLK_Source_TypeDef CLK_NewClock,
+				  FunctionalState ITState, CLK_CurrentClockState_TypeDef CLK_CurrentClockState);
+uint32_t CLK_GetClockFreq(void);
+
+/* SPL: GPIO -----------------------------------------------------------------*/
+
+typedef enum {
+	GPIO_MODE_IN_FL_NO_IT      = (uint8_t)0x00,
+	GPIO_MODE_IN_PU_NO_IT      = (uint8_t)0x40,
+	GPIO_MODE_IN_FL_IT         = (uint8_t)0x20,
+	GPIO_MODE_IN_PU_IT         = (uint8_t)0x60,
+	GPIO_MODE_OUT_OD_LOW_FAST  = (uint8_t)0xA0,
+	GPIO_MODE_OUT_PP_LOW_FAST  = (uint8_t)0xE0,
+	GPIO_MODE_OUT_OD_LOW_SLOW  = (uint8_t)0x80,
+	GPIO_MODE_OUT_PP_LOW_SLOW  = (uint8_t)0xC0,
+	GPIO_MODE_OUT_OD_HIZ_FAST  = (uint8_t)0xB0,
+	GPIO_MODE_OUT_PP_HIGH_FAST = (uint8_t)0xF0,
+	GPIO_MODE_OUT_OD_HIZ_SLOW  = (uint8_t)0x90,
+	GPIO_MODE_OUT_PP_HIGH_SLOW = (uint8_t)0xD0
+} GPIO_Mode_TypeDef;
+
+typedef enum {
+	GPIO_PIN_0    = ((uint8_t)0x01),
+	GPIO_PIN_1    = ((uint8_t)0x02),
+	GPIO_PIN_2    = ((uint8_t)0x04),
+	GPIO_PIN_3    = ((uint8_t)0x08),
+	GPIO_PIN_4    = ((uint8_t)0x10),
+	GPIO_PIN_5    = ((uint8_t)0x20),
+	GPIO_PIN_6    = ((uint8_t)0x40),
+	GPIO_PIN_7    = ((uint8_t)0x80),
+	GPIO_PIN_LNIB = ((uint8_t)0x0F),
+	GPIO_PIN_HNIB = ((uint8_t)0xF0),
+	GPIO_PIN_ALL  = ((uint8_t)0xFF)
+} GPIO_Pin_TypeDef;
+
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef GPIO_Pin, GPIO_Mode_TypeDef GPIO_Mode);
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint8_t PortVal);
+void GPIO_WriteHigh(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins);
+void GPIO_WriteLow(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins);
+void GPIO_WriteReverse(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins);
+uint8_t GPIO_ReadInputData(GPIO_TypeDef* GPIOx);
+uint8_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx);
+BitStatus GPIO_ReadInputPin(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef GPIO_Pin);
+
+/* SPL: EXTI -----------------------------------------------------------------*/
+
+typedef enum {
+	EXTI_SENSITIVITY_FALL_LOW  = (uint8_t)0x00,
+	EXTI_SENSITIVITY_RISE_ONLY = (uint8_t)0x01,
+	EXTI_SENSITIVITY_FALL_ONLY = (uint8_t)0x02,
+	EXTI_SENSITIVITY_RISE_FALL = (uint8_t)0x03
+} EXTI_Sensitivity_TypeDef;
+
+typedef enum {
+	EXTI_PORT_GPIOA = (uint8_t)0x00,
+	EXTI_PORT_GPIOB = (uint8_t)0x01,
+	EXTI_PORT_GPIOC = (uint8_t)0x02,
+	EXTI_PORT_GPIOD = (uint8_t)0x03,
+	EXTI_PORT_GPIOE = (uint8_t)0x04
+} EXTI_Port_TypeDef;
+
+void EXTI_SetExtIntSensitivity(EXTI_Port_TypeDef Port, EXTI_Sensitivity_TypeDef SensitivityValue);
+EXTI_Sensitivity_TypeDef EXTI_GetExtIntSensitivity(EXTI_Port_TypeDef Port);
+
+/* SPL: AWU ------------------------------------------------------------------*/
+
+typedef enum {
+	AWU_TIMEBASE_NO_IT  = (uint8_t)0,
+	AWU_TIMEBASE_250US  = (uint8_t)1,
+	AWU_TIMEBASE_500US  = (uint8_t)2,
+	AWU_TIMEBASE_1MS    = (uint8_t)3,
+	AWU_TIMEBASE_2MS    = (uint8_t)4,
+	AWU_TIMEBASE_4MS    = (uint8_t)5,
+	AWU_TIMEBASE_8MS    = (uint8_t)6,
+	AWU_TIMEBASE_16MS   = (uint8_t)7,
+	AWU_TIMEBASE_32MS   = (uint8_t)8,
+	AWU_TIMEBASE_64MS   = (uint8_t)9,
+	AWU_TIMEBASE_128MS  = (uint8_t)10,
+	AWU_TIMEBASE_256MS  = (uint8_t)11,
+	AWU_TIMEBASE_512MS  = (uint8_t)12,
+	AWU_TIMEBASE_1S     = (uint8_t)13,
+	AWU_TIMEBASE_2S     = (uint8_t)14,
+	AWU_TIMEBASE_12S    = (uint8_t)15,
+	AWU_TIMEBASE_30S    = (uint8_t)16
+} AWU_Timebase_TypeDef;
+
+void AWU_Init(AWU_Timebase_TypeDef AWU_TimeBase);
+void AWU_Cmd(FunctionalState NewState);
+
+/* SPL: ADC1 -----------------------------------------------------------------*/
+
+typedef enum {
+	ADC1_CONVERSIONMODE_SINGLE     = (uint8_t)0x00,
+	ADC1_CONVERSIONMODE_CONTINUOUS = (uint8_t)0x01
+} ADC1_ConvMode_TypeDef;
+
+typedef enum {
+	ADC1_CHANNEL_0  = (uint8_t)0x00,
+	ADC1_CHANNEL_1  = (uint8_t)0x01,
+	ADC1_CHANNEL_2  = (uint8_t)0x02,
+	ADC1_CHANNEL_3  = (uint8_t)0x03,
+	ADC1_CHANNEL_4  = (uint8_t)0x04,
+	ADC1_CHANNEL_5  = (uint8_t)0x05,
+	ADC1_CHANNEL_6  = (uint8_t)0x06,
+	ADC1_CHANNEL_7  = (uint8_t)0x07,
+	ADC1_CHANNEL_8  = (uint8_t)0x08,
+	ADC1_CHANNEL_9  = (uint8_t)0x09,
+	ADC1_CHANNEL_12 = (uint8_t)0x0C
+} ADC1_Channel_TypeDef;
+
+typedef enum {
+	ADC1_PRESSEL_FCPU_D2  = (uint8_t)0x00,
+	ADC1_PRESSEL_FCPU_D3  = (uint8_t)0x10,
+	ADC1_PRESSEL_FCPU_D4  = (uint8_t)0x20,
+	ADC1_PRESSEL_FCPU_D6  = (uint8_t)0x30,
+	ADC1_PRESSEL_FCPU_D8  = (uint8_t)0x40,
+	ADC1_PRESSEL_FCPU_D10 = (uint8_t)0x50,
+	ADC1_PRESSEL_FCPU_D12 = (uint8_t)0x60,
+	ADC1_PRESSEL_FCPU_D18 = (uint8_t)0x70
+} ADC1_PresSel_TypeDef;
+
+typedef enum {
+	ADC1_EXTTRIG_TIM  = (uint8_t)0x00,
+	ADC1_EXTTRIG_GPIO = (uint8_t)0x10
+} ADC1_ExtTrig_TypeDef;
+
+typedef enum {
+	ADC1_ALIGN_LEFT  = (uint8_t)0x00,
+	ADC1_ALIGN_RIGHT = (uint8_t)0x08
+} ADC1_Align_TypeDef;
+
+typedef enum {
+	ADC1_SCHMITTTRIG_CHANNEL0  = (uint8_t)0x00,
+	ADC1_SCHMITTTRIG_CHANNEL1  = (uint8_t)0x01,
+	ADC1_SCHMITTTRIG_CHANNEL2  = (uint8_t)0x02,
+	ADC1_SCHMITTTRIG_CHANNEL3  = (uint8_t)0x03,
+	ADC1_SCHMITTTRIG_CHANNEL4  = (uint8_t)0x04,
+	ADC1_SCHMITTTRIG_CHANNEL5  = (uint8_t)0x05,
+	ADC1_SCHMITTTRIG_CHANNEL6  = (uint8_t)0x06,
+	ADC1_SCHMITTTRIG_CHANNEL7  = (uint8_t)0x07,
+	ADC1_SCHMITTTRIG_CHANNEL8  = (uint8_t)0x08,
+	ADC1_SCHMITTTRIG_CHANNEL12 = (uint8_t)0x0C,
+	ADC1_SCHMITTTRIG_ALL       = (uint8_t)0xFF
+} ADC1_SchmittTrigg_TypeDef;
+
+typedef enum {
+	ADC1_IT_AWDIE = (uint16_t)0x010,
+	ADC1_IT_EOCIE = (uint16_t)0x020,
+	ADC1_IT_AWD   = (uint16_t)0x140,
+	ADC1_IT_EOC   = (uint16_t)0x080
+} ADC1_IT_TypeDef;
+
+void ADC1_DeInit(void);
+void ADC1_Init(ADC1_ConvMode_TypeDef ADC1_ConversionMode, ADC1_Channel_TypeDef ADC1_Channel,
+	       ADC1_PresSel_TypeDef ADC1_PrescalerSelection, ADC1_ExtTrig_TypeDef ADC1_ExtTrigger,
+	       FunctionalState ADC1_ExtTriggerState, ADC1_Align_TypeDef ADC1_Align,
+	       ADC1_SchmittTrigg_TypeDef ADC1_SchmittTriggerChannel, FunctionalState ADC1_SchmittTriggerState);
+void ADC1_Cmd(FunctionalState NewState);
+void ADC1_PrescalerConfig(ADC1_PresSel_TypeDef ADC1_Prescaler);
+void ADC1_ScanModeCmd(FunctionalState NewState);
+void ADC1_ITConfig(ADC1_IT_TypeDef ADC1_IT, FunctionalState NewState);
+void ADC1_StartConversion(void);
+uint16_t ADC1_GetConversionValue(void);
+void ADC1_AWDChannelConfig(ADC1_Channel_TypeDef Channel, FunctionalState NewState);
+void ADC1_SetHighThreshold(uint16_t Threshold);
+void ADC1_SetLowThreshold(uint16_t Threshold);
+
+/* SPL: TIM1 -----------------------------------------------------------------*/
+
+typedef enum {
+	TIM1_COUNTERMODE_UP             = (uint8_t)0x00,
+	TIM1_COUNTERMODE_DOWN           = (uint8_t)0x10,
+	TIM1_COUNTERMODE_CENTERALIGNED1 = (uint8_t)0x20,
+	TIM1_COUNTERMODE_CENTERALIGNED2 = (uint8_t)0x40,
+	TIM1_COUNTERMODE_CENTERALIGNED3 = (uint8_t)0x60
+} TIM1_CounterMode_TypeDef;
+
+typedef enum {
+	TIM1_TRGOSOURCE_RESET  = (uint8_t)0x00,
+	TIM1_TRGOSOURCE_ENABLE = (uint8_t)0x10,
+	TIM1_TRGOSOURCE_UPDATE = (uint8_t)0x20,
+	TIM1_TRGOSOURCE_OC1    = (uint8_t)0x30,
+	TIM1_TRGOSOURCE_OC1REF = (uint8_t)0x40,
+	TIM1_TRGOSOURCE_OC2REF = (uint8_t)0x50,
+	TIM1_TRGOSOURCE_OC3REF = (uint8_t)0x60
+} TIM1_TRGOSource_TypeDef;
+
+void TIM1_DeInit(void);
+void TIM1_TimeBaseInit(uint16_t TIM1_Prescaler, TIM1_CounterMode_TypeDef TIM1_CounterMode,
+		       uint16_t TIM1_Period, uint8_t TIM1_RepetitionCounter);
+void TIM1_SelectOutputTrigger(TIM1_TRGOSource_TypeDef TIM1_TRGOSource);
+void TIM1_Cmd(FunctionalState NewState);
+
+/* SPL: TIM2 -----------------------------------------------------------------*/
+
+typedef enum {
+	TIM2_PRESCALER_1     = ((uint8_t)0x00),
+	TIM2_PRESCALER_2     = ((uint8_t)0x01),
+	TIM2_PRESCALER_4     = ((uint8_t)0x02),
+	TIM2_PRESCALER_8     = ((uint8_t)0x03),
+	TIM2_PRESCALER_16    = ((uint8_t)0x04),
+	TIM2_PRESCALER_32    = ((uint8_t)0x05),
+	TIM2_PRESCALER_64    = ((uint8_t)0x06),
+	TIM2_PRESCALER_128   = ((uint8_t)0x07),
+	TIM2_PRESCALER_256   = ((uint8_t)0x08),
+	TIM2_PRESCALER_512   = ((uint8_t)0x09),
+	TIM2_PRESCALER_1024  = ((uint8_t)0x0A),
+	TIM2_PRESCALER_2048  = ((uint8_t)0x0B),
+	TIM2_PRESCALER_4096  = ((uint8_t)0x0C),
+	TIM2_PRESCALER_8192  = ((uint8_t)0x0D),
+	TIM2_PRESCALER_16384 = ((uint8_t)0x0E),
+	TIM2_PRESCALER_32768 = ((uint8_t)0x0F)
+} TIM2_Prescaler_TypeDef;
+
+typedef enum {
+	TIM2_OCMODE_TIMING   = ((uint8_t)0x00),
+	TIM2_OCMODE_ACTIVE   = ((uint8_t)0x10),
+	TIM2_OCMODE_INACTIVE = ((uint8_t)0x20),
+	TIM2_OCMODE_TOGGLE   = ((uint8_t)0x30),
+	TIM2_OCMODE_PWM1     = ((uint8_t)0x60),
+	TIM2_OCMODE_PWM2     = ((uint8_t)0x70)
+} TIM2_OCMode_TypeDef;
+
+typedef enum {
+	TIM2_OUTPUTSTATE_DISABLE = ((uint8_t)0x00),
+	TIM2_OUTPUTSTATE_ENABLE  = ((uint8_t)0x11)
+} TIM2_OutputState_TypeDef;
+
+typedef enum {
+	TIM2_OCPOLARITY_HIGH = ((uint8_t)0x00),
+	TIM2_OCPOLARITY_LOW  = ((uint8_t)0x22)
+} TIM2_OCPolarity_TypeDef;
+
+void TIM2_TimeBaseInit(TIM2_Prescaler_TypeDef TIM2_Prescaler, uint16_t TIM2_Period);
+void TIM2_OC1Init(TIM2_OCMode_TypeDef TIM2_OCMode, TIM2_OutputState_TypeDef TIM2_OutputState,
+		  uint16_t TIM2_Pulse, TIM2_OCPolarity_TypeDef TIM2_OCPolarity);
+void TIM2_OC1PreloadConfig(FunctionalState NewState);
+void TIM2_ARRPreloadConfig(FunctionalState NewState);
+void TIM2_Cmd(FunctionalState NewState);
+
+/* SPL: TIM4 -----------------------------------------------------------------*/
+
+typedef enum {
+	TIM4_PRESCALER_1   = ((uint8_t)0x00),
+	TIM4_PRESCALER_2   = ((uint8_t)0x01),
+	TIM4_PRESCALER_4   = ((uint8_t)0x02),
+	TIM4_PRESCALER_8   = ((uint8_t)0x03),
+	TIM4_PRESCALER_16  = ((uint8_t)0x04),
+	TIM4_PRESCALER_32  = ((uint8_t)0x05),
+	TIM4_PRESCALER_64  = ((uint8_t)0x06),
+	TIM4_PRESCALER_128 = ((uint8_t)0x07)
+} TIM4_Prescaler_TypeDef;
+
+typedef enum {
+	TIM4_OPMODE_SINGLE     = ((uint8_t)0x01),
+	TIM4_OPMODE_REPETITIVE = ((uint8_t)0x00)
+} TIM4_OPMode_TypeDef;
+
+typedef enum {
+	TIM4_IT_UPDATE = ((uint8_t)0x01)
+} TIM4_IT_TypeDef;
+
+typedef enum {
+	TIM4_FLAG_UPDATE = ((uint8_t)0x01)
+} TIM4_FLAG_TypeDef;
+
+void TIM4_DeInit(void);
+void TIM4_TimeBaseInit(TIM4_Prescaler_TypeDef TIM4_Prescaler, uint8_t TIM4_Period);
+void TIM4_SelectOnePulseMode(TIM4_OPMode_TypeDef TIM4_OPMode);
+void TIM4_ITConfig(TIM4_IT_TypeDef TIM4_IT, FunctionalState NewState);
+void TIM4_ClearFlag(TIM4_FLAG_TypeDef TIM4_FLAG);
+void TIM4_ARRPreloadConfig(FunctionalState NewState);
+void TIM4_Cmd(FunctionalState NewState);
+
+typedef enum {
+	ITC_IRQ_TLI = 0, ITC_IRQ_AWU = 1, ITC_IRQ_CLK = 2,
+	ITC_IRQ_PORTA = 3, ITC_IRQ_PORTB = 4, ITC_IRQ_PORTC = 5, ITC_IRQ_PORTD = 6, ITC_IRQ_PORTE = 7,
+	ITC_IRQ_SPI = 10, ITC_IRQ_TIM1_OVF = 11, ITC_IRQ_TIM1_CAPCOM = 12,
+	ITC_IRQ_TIM2_OVF = 13, ITC_IRQ_TIM2_CAPCOM = 14,
+	ITC_IRQ_UART1_TX = 17, ITC_IRQ_UART1_RX = 18, ITC_IRQ_I2C = 19,
+	ITC_IRQ_ADC1 = 22, ITC_IRQ_TIM4_OVF = 23, ITC_IRQ_EEPROM_EEC = 24
+} ITC_Irq_TypeDef;
+
+typedef enum {
+	ITC_PRIORITYLEVEL_0 = 0x02, ITC_PRIORITYLEVEL_1 = 0x01,
+	ITC_PRIORITYLEVEL_2 = 0x00, ITC_PRIORITYLEVEL_3 = 0x03
+} ITC_PriorityLevel_TypeDef;
+
+// Priorities are stored in ITC_SPRx, but handlers do not nest on the host
+void ITC_SetSoftwarePriority(ITC_Irq_TypeDef IrqNum, ITC_PriorityLevel_TypeDef PriorityValue);
+ITC_PriorityLevel_TypeDef ITC_GetSoftwarePriority(ITC_Irq_TypeDef IrqNum);
+
+/* Host simulation -----------------------------------------------------------*/
+
+// The firmware's main(), renamed by -D main=app_main in the native
+// environment (See platformio.ini). The default main() of host_main.c
+// resets the registers and runs it, a test may provide its own main().
+void app_main(void);
+
+extern volatile bool host_interrupts_enabled;
+
+// Called by wfi() and halt(). A test points this to a function that
+// changes the inputs or raises interrupts, ex. through the functions
+// below, or leaves main() through longjmp() once it has seen enough.
+extern void (*host_idle_hook)(bool halt);
+
+void host_reset(void);				// Registers to their reset values, interrupts disabled, no HSE, no LSI_EN
+void host_enable_interrupts(void);		// Also runs any handler raised while disabled
+void host_idle(bool halt);
+void host_raise(void (*handler)(void));	// Runs the handler now, or once interrupts are enabled
+
+// Clock sources CLK_ClockSwitchConfig() may switch to besides the HSI:
+// a crystal on PA1/PA2, which the blue board does not have, and the LSI,
+// which is only available as master clock if the LSI_EN option byte is set.
+// Switching to an unavailable source times out like on the real chip.
+extern bool host_hse_fitted;
+extern bool host_lsi_enabled;
+
+// Changes the level of an input pin. Raises the port's EXTI handler if
+// the pin has its interrupt enabled (CR2) and the edge matches the
+// sensitivity set in EXTI_CR1/CR2.
+void host_gpio_input(GPIO_TypeDef *port, uint8_t pin, bool high);
+bool host_gpio_output(GPIO_TypeDef *port, uint8_t pin);
+
+// Completes a conversion of the selected channel with the given 10-bit
+// result. Sets EOC and raises ADC1_IRQHandler if EOCIE is set. In scan
+// mode, values holds one result per channel from 0 to the selected one.
+// Since the host is little-endian, the data buffer registers are stored
+// so that reading a register pair as uint16_t yields the result, just
+// like on the big-endian STM8. Also updates the analog watchdog.
+void host_adc_convert(uint16_t value);
+void host_adc_scan(const uint16_t *values);
+
+// Lets TIM4 overflow once. Sets UIF, raises TIM4_UPD_OVF_IRQHandler if UIE
+// is set and stops the counter in one-pulse mode.
+void host_tim4_overflow(void);
+
+// Lets TIM4 count for the given number of CPU cycles, through the prescaler
+// it loaded on its last update event, overflowing as often as it would on
+// the STM8. An update forced through EGR UG takes effect at the start of
+// the call, without setting UIF, which the examples clear right after.
+void host_tim4_run(uint32_t cycles);
+
+// UART1: host_uart_receive() makes a byte arrive and raises the RX handler,
+// host_uart_transmit() lets the TX handler move the next byte into DR and
+// returns TRUE with the byte if it did so.
+void host_uart_receive(uint8_t c);
+bool host_uart_transmit(uint8_t *c);
+
+#endif /* _STM8S_HOST_H_INCLUDED_ */
@@ -13,20 +13,18 @@
 
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
- * 
- * Description: Header file for delay_ms function
- * 
+ *
+ * Description: Default entry point of the native build, replaced by
+ * 		the main() of a test if it provides one.
  */
 
-#ifndef _DELAY_H_INCLUDED_
-#define _DELAY_H_INCLUDED_
+#include <stm8s.h>
 
-#include <stdint.h>
+#undef main // build_flags also apply to libraries, only the firmware's main() is renamed
 
-#ifndef F_CPU
-#error "F_CPU not defined"
-#endif
-
-void delay_ms(uint16_t ms);
-
-#endif /* _DELAY_H_INCLUDED_ */
\ No newline at end of file
+__attribute__((weak)) int main(void)
+{
+	host_reset();
+	app_main();
+	return 0;
+}
@@ -0,0 +1,777 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Register-level implementation of the host replacement
+ * 		for the SPL (See stm8s.h). The SPL functions follow the
+ * 		register accesses of the original drivers, the host_*
+ * 		functions play the part of the hardware.
+ */
+
+#include <stm8s.h>
+
+// Interrupt handlers of the project (See stm8s_it.c)
+void TRAP_IRQHandler(void);
+void EXTI_PORTA_IRQHandler(void);
+void EXTI_PORTB_IRQHandler(void);
+void EXTI_PORTC_IRQHandler(void);
+void EXTI_PORTD_IRQHandler(void);
+void EXTI_PORTE_IRQHandler(void);
+void ADC1_IRQHandler(void);
+void TIM4_UPD_OVF_IRQHandler(void);
+void UART1_TX_IRQHandler(void);
+void UART1_RX_IRQHandler(void);
+
+host_regs_t host_regs;
+volatile bool host_interrupts_enabled;
+bool host_hse_fitted;
+bool host_lsi_enabled;
+void (*host_idle_hook)(bool halt);
+
+/* Interrupts ----------------------------------------------------------------*/
+
+#define MAX_PENDING 8
+
+static void (*_pending[MAX_PENDING])(void);
+static uint8_t _npending;
+
+// TIM4 prescaler in use, PSCR is preloaded and only takes effect on an
+// update event, and the CPU cycles counted towards the next timer tick
+static uint8_t _tim4_psc;
+static uint8_t _tim4_div;
+
+// Handlers of the same priority do not nest, and iret restores the mask
+static void run_handler(void (*handler)(void))
+{
+	bool enabled = host_interrupts_enabled;
+
+	host_interrupts_enabled = FALSE;
+	handler();
+	host_interrupts_enabled = enabled;
+}
+
+static void run_pending(void)
+{
+	while (host_interrupts_enabled && _npending) {
+		void (*handler)(void) = _pending[0];
+		uint8_t i;
+
+		for (i = 1; i < _npending; i++)
+			_pending[i - 1] = _pending[i];
+		_npending--;
+
+		run_handler(handler);
+	}
+}
+
+void host_raise(void (*handler)(void))
+{
+	uint8_t i;
+
+	if (host_interrupts_enabled) {
+		run_handler(handler);
+		run_pending();
+		return;
+	}
+
+	// Like the pending bit of a real interrupt source, raising it twice
+	// before it is served only runs the handler once
+	for (i = 0; i < _npending; i++) {
+		if (_pending[i] == handler)
+			return;
+	}
+
+	if (_npending < MAX_PENDING)
+		_pending[_npending++] = handler;
+}
+
+void host_enable_interrupts(void)
+{
+	host_interrupts_enabled = TRUE;
+	run_pending();
+}
+
+void host_idle(bool halt)
+{
+	host_enable_interrupts(); // wfi and halt both set the interrupt mask to level 0
+
+	if (host_idle_hook)
+		host_idle_hook(halt);
+}
+
+void host_reset(void)
+{
+	uint8_t *regs = (uint8_t *)&host_regs;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(host_regs); i++)
+		regs[i] = 0;
+
+	// Non-zero reset values (See the register maps in the STM8S103 datasheet)
+	ITC->ISPR1 = ITC->ISPR2 = ITC->ISPR3 = ITC->ISPR4 = 0xFF;
+	ITC->ISPR5 = ITC->ISPR6 = ITC->ISPR7 = ITC->ISPR8 = 0xFF;
+	CLK->ICKR = CLK_ICKR_HSIEN | CLK_ICKR_HSIRDY;
+	CLK->CMSR = 0xE1;
+	CLK->SWR = 0xE1;
+	CLK->CKDIVR = 0x18;
+	CLK->PCKENR1 = 0xFF;
+	CLK->PCKENR2 = 0xFF;
+	FLASH->NCR2 = 0xFF;
+	FLASH->NFPR = 0xFF;
+	FLASH->IAPSR = 0x40;
+	AWU->APR = 0x3F;
+	TIM1->ARRH = TIM1->ARRL = 0xFF;
+	TIM2->ARRH = TIM2->ARRL = 0xFF;
+	TIM4->ARR = 0xFF;
+	UART1->SR = UART1_SR_TXE | UART1_SR_TC;
+	SPI->SR = 0x02; // TXE
+
+	host_interrupts_enabled = FALSE;
+	host_hse_fitted = FALSE;
+	host_lsi_enabled = FALSE;
+	_npending = 0;
+	_tim4_psc = 0;
+	_tim4_div = 0;
+}
+
+/* CLK -----------------------------------------------------------------------*/
+
+void CLK_HSIPrescalerConfig(CLK_Prescaler_TypeDef HSIPrescaler)
+{
+	CLK->CKDIVR &= (uint8_t)(~CLK_CKDIVR_HSIDIV);
+	CLK->CKDIVR |= (uint8_t)HSIPrescaler;
+}
+
+// Automatic switch mode only, the switch completes at once if the new
+// source is available and leaves SWBSY set otherwise
+ErrorStatus CLK_ClockSwitchConfig(CLK_SwitchMode_TypeDef CLK_SwitchMode, CLK_Source_TypeDef CLK_NewClock,
+				  FunctionalState ITState, CLK_CurrentClockState_TypeDef CLK_CurrentClockState)
+{
+	CLK_Source_TypeDef clock_master = (CLK_Source_TypeDef)CLK->CMSR;
+	bool ready = CLK_NewClock == CLK_SOURCE_HSI ||
+		     (CLK_NewClock == CLK_SOURCE_HSE && host_hse_fitted) ||
+		     (CLK_NewClock == CLK_SOURCE_LSI && host_lsi_enabled);
+
+	(void)CLK_SwitchMode;
+
+	CLK->SWCR |= CLK_SWCR_SWEN;
+	if (ITState != DISABLE)
+		CLK->SWCR |= CLK_SWCR_SWIEN;
+	else
+		CLK->SWCR &= (uint8_t)(~CLK_SWCR_SWIEN);
+	CLK->SWR = (uint8_t)CLK_NewClock;
+
+	if (!ready) {
+		CLK->SWCR |= CLK_SWCR_SWBSY; // New source never becomes ready
+		return ERROR;
+	}
+
+	// The automatic switch turns the new source on
+	if (CLK_NewClock == CLK_SOURCE_HSI)
+		CLK->ICKR |= CLK_ICKR_HSIEN | CLK_ICKR_HSIRDY;
+	else if (CLK_NewClock == CLK_SOURCE_LSI)
+		CLK->ICKR |= CLK_ICKR_LSIEN | CLK_ICKR_LSIRDY;
+	else
+		CLK->ECKR |= CLK_ECKR_HSEEN | CLK_ECKR_HSERDY;
+
+	CLK->CMSR = (uint8_t)CLK_NewClock;
+	CLK->SWCR &= (uint8_t)(~(CLK_SWCR_SWEN | CLK_SWCR_SWBSY));
+
+	if (CLK_CurrentClockState == CLK_CURRENTCLOCKSTATE_DISABLE && clock_master != CLK_NewClock) {
+		if (clock_master == CLK_SOURCE_HSI)
+			CLK->ICKR &= (uint8_t)(~(CLK_ICKR_HSIEN | CLK_ICKR_HSIRDY));
+		else if (clock_master == CLK_SOURCE_LSI)
+			CLK->ICKR &= (uint8_t)(~(CLK_ICKR_LSIEN | CLK_ICKR_LSIRDY));
+		else
+			CLK->ECKR &= (uint8_t)(~(CLK_ECKR_HSEEN | CLK_ECKR_HSERDY));
+	}
+
+	return SUCCESS;
+}
+
+uint32_t CLK_GetClockFreq(void)
+{
+	if (CLK->CMSR == CLK_SOURCE_HSI)
+		return HSI_VALUE >> ((CLK->CKDIVR & CLK_CKDIVR_HSIDIV) >> 3);
+	if (CLK->CMSR == CLK_SOURCE_LSI)
+		return LSI_VALUE;
+	return HSE_VALUE;
+}
+
+/* GPIO ----------------------------------------------------------------------*/
+
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef GPIO_Pin, GPIO_Mode_TypeDef GPIO_Mode)
+{
+	GPIOx->CR2 &= (uint8_t)(~(GPIO_Pin));
+
+	if ((GPIO_Mode & (uint8_t)0x80) != 0) {
+		if ((GPIO_Mode & (uint8_t)0x10) != 0)
+			GPIOx->ODR |= (uint8_t)GPIO_Pin;
+		else
+			GPIOx->ODR &= (uint8_t)(~(GPIO_Pin));
+		GPIOx->DDR |= (uint8_t)GPIO_Pin;
+	} else {
+		GPIOx->DDR &= (uint8_t)(~(GPIO_Pin));
+	}
+
+	if ((GPIO_Mode & (uint8_t)0x40) != 0)
+		GPIOx->CR1 |= (uint8_t)GPIO_Pin;
+	else
+		GPIOx->CR1 &= (uint8_t)(~(GPIO_Pin));
+
+	if ((GPIO_Mode & (uint8_t)0x20) != 0)
+		GPIOx->CR2 |= (uint8_t)GPIO_Pin;
+	else
+		GPIOx->CR2 &= (uint8_t)(~(GPIO_Pin));
+}
+
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint8_t PortVal)
+{
+	GPIOx->ODR = PortVal;
+}
+
+void GPIO_WriteHigh(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins)
+{
+	GPIOx->ODR |= (uint8_t)PortPins;
+}
+
+void GPIO_WriteLow(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins)
+{
+	GPIOx->ODR &= (uint8_t)(~PortPins);
+}
+
+void GPIO_WriteReverse(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef PortPins)
+{
+	GPIOx->ODR ^= (uint8_t)PortPins;
+}
+
+uint8_t GPIO_ReadInputData(GPIO_TypeDef* GPIOx)
+{
+	return GPIOx->IDR;
+}
+
+uint8_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx)
+{
+	return GPIOx->ODR;
+}
+
+BitStatus GPIO_ReadInputPin(GPIO_TypeDef* GPIOx, GPIO_Pin_TypeDef GPIO_Pin)
+{
+	return (BitStatus)(GPIOx->IDR & (uint8_t)GPIO_Pin);
+}
+
+bool host_gpio_output(GPIO_TypeDef *port, uint8_t pin)
+{
+	return (port->ODR & pin) != 0;
+}
+
+void host_gpio_input(GPIO_TypeDef *port, uint8_t pin, bool high)
+{
+	static void (*const handlers[])(void) = {
+		EXTI_PORTA_IRQHandler, EXTI_PORTB_IRQHandler, EXTI_PORTC_IRQHandler,
+		EXTI_PORTD_IRQHandler, EXTI_PORTE_IRQHandler
+	};
+	bool was_high = (port->IDR & pin) != 0;
+	uint8_t index;
+	EXTI_Sensitivity_TypeDef sens;
+
+	if (high)
+		port->IDR |= pin;
+	else
+		port->IDR &= (uint8_t)(~pin);
+
+	// Only inputs with their interrupt enabled trigger, and only on an edge
+	if (high == was_high || (port->DDR & pin) || !(port->CR2 & pin))
+		return;
+
+	index = (uint8_t)(port - GPIOA);
+	if (index > EXTI_PORT_GPIOE)
+		return;
+
+	sens = EXTI_GetExtIntSensitivity((EXTI_Port_TypeDef)index);
+	if ((high && (sens == EXTI_SENSITIVITY_RISE_ONLY || sens == EXTI_SENSITIVITY_RISE_FALL)) ||
+	    (!high && sens != EXTI_SENSITIVITY_RISE_ONLY))
+		host_raise(handlers[index]);
+}
+
+/* EXTI ----------------------------------------------------------------------*/
+
+void EXTI_SetExtIntSensitivity(EXTI_Port_TypeDef Port, EXTI_Sensitivity_TypeDef SensitivityValue)
+{
+	if (Port == EXTI_PORT_GPIOE) {
+		EXTI->CR2 = (uint8_t)((EXTI->CR2 & 0xFC) | SensitivityValue);
+	} else {
+		uint8_t shift = (uint8_t)(Port * 2);
+		EXTI->CR1 = (uint8_t)((EXTI->CR1 & ~(0x03 << shift)) | (SensitivityValue << shift));
+	}
+}
+
+EXTI_Sensitivity_TypeDef EXTI_GetExtIntSensitivity(EXTI_Port_TypeDef Port)
+{
+	if (Port == EXTI_PORT_GPIOE)
+		return (EXTI_Sensitivity_TypeDef)(EXTI->CR2 & 0x03);
+
+	return (EXTI_Sensitivity_TypeDef)((EXTI->CR1 >> (Port * 2)) & 0x03);
+}
+
+/* AWU -----------------------------------------------------------------------*/
+
+// Prescaler and time base selection per AWU_Timebase_TypeDef, as in stm8s_awu.c
+static const uint8_t _awu_apr[17] = {0, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 61, 23, 23, 62};
+static const uint8_t _awu_tbr[17] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 12, 14, 15, 15};
+
+void AWU_Init(AWU_Timebase_TypeDef AWU_TimeBase)
+{
+	AWU->CSR |= AWU_CSR_AWUEN;
+	AWU->TBR = (uint8_t)((AWU->TBR & 0xF0) | _awu_tbr[AWU_TimeBase]);
+	AWU->APR = (uint8_t)((AWU->APR & 0xC0) | _awu_apr[AWU_TimeBase]);
+}
+
+void AWU_Cmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		AWU->CSR |= AWU_CSR_AWUEN;
+	else
+		AWU->CSR &= (uint8_t)(~AWU_CSR_AWUEN);
+}
+
+/* ADC1 ----------------------------------------------------------------------*/
+
+void ADC1_DeInit(void)
+{
+	uint8_t *regs = (uint8_t *)ADC1;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(*ADC1); i++)
+		regs[i] = 0;
+
+	ADC1->HTRH = 0xFF;
+	ADC1->HTRL = 0x03;
+}
+
+void ADC1_Init(ADC1_ConvMode_TypeDef ADC1_ConversionMode, ADC1_Channel_TypeDef ADC1_Channel,
+	       ADC1_PresSel_TypeDef ADC1_PrescalerSelection, ADC1_ExtTrig_TypeDef ADC1_ExtTrigger,
+	       FunctionalState ADC1_ExtTriggerState, ADC1_Align_TypeDef ADC1_Align,
+	       ADC1_SchmittTrigg_TypeDef ADC1_SchmittTriggerChannel, FunctionalState ADC1_SchmittTriggerState)
+{
+	// Conversion mode, alignment and channel
+	ADC1->CR2 = (uint8_t)((ADC1->CR2 & ~ADC1_CR2_ALIGN) | ADC1_Align);
+	if (ADC1_ConversionMode == ADC1_CONVERSIONMODE_CONTINUOUS)
+		ADC1->CR1 |= ADC1_CR1_CONT;
+	else
+		ADC1->CR1 &= (uint8_t)(~ADC1_CR1_CONT);
+	ADC1->CSR = (uint8_t)((ADC1->CSR & ~ADC1_CSR_CH) | ADC1_Channel);
+
+	// Prescaler
+	ADC1->CR1 = (uint8_t)((ADC1->CR1 & ~ADC1_CR1_SPSEL) | ADC1_PrescalerSelection);
+
+	// Schmitt trigger, TDR bits disable it
+	if (ADC1_SchmittTriggerChannel == ADC1_SCHMITTTRIG_ALL) {
+		ADC1->TDRL = ADC1->TDRH = (ADC1_SchmittTriggerState != DISABLE) ? 0x00 : 0xFF;
+	} else if (ADC1_SchmittTriggerChannel < 8) {
+		uint8_t bit = (uint8_t)(1 << ADC1_SchmittTriggerChannel);
+		if (ADC1_SchmittTriggerState != DISABLE)
+			ADC1->TDRL &= (uint8_t)(~bit);
+		else
+			ADC1->TDRL |= bit;
+	} else {
+		uint8_t bit = (uint8_t)(1 << (ADC1_SchmittTriggerChannel - 8));
+		if (ADC1_SchmittTriggerState != DISABLE)
+			ADC1->TDRH &= (uint8_t)(~bit);
+		else
+			ADC1->TDRH |= bit;
+	}
+
+	// External trigger
+	ADC1->CR2 = (uint8_t)((ADC1->CR2 & ~ADC1_CR2_EXTSEL) | ADC1_ExtTrigger);
+	if (ADC1_ExtTriggerState != DISABLE)
+		ADC1->CR2 |= ADC1_CR2_EXTTRIG;
+	else
+		ADC1->CR2 &= (uint8_t)(~ADC1_CR2_EXTTRIG);
+}
+
+void ADC1_Cmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		ADC1->CR1 |= ADC1_CR1_ADON;
+	else
+		ADC1->CR1 &= (uint8_t)(~ADC1_CR1_ADON);
+}
+
+void ADC1_PrescalerConfig(ADC1_PresSel_TypeDef ADC1_Prescaler)
+{
+	ADC1->CR1 &= (uint8_t)(~ADC1_CR1_SPSEL);
+	ADC1->CR1 |= (uint8_t)ADC1_Prescaler;
+}
+
+void ADC1_ScanModeCmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		ADC1->CR2 |= ADC1_CR2_SCAN;
+	else
+		ADC1->CR2 &= (uint8_t)(~ADC1_CR2_SCAN);
+}
+
+void ADC1_ITConfig(ADC1_IT_TypeDef ADC1_IT, FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		ADC1->CSR |= (uint8_t)ADC1_IT;
+	else
+		ADC1->CSR &= (uint8_t)(~(uint8_t)ADC1_IT);
+}
+
+void ADC1_StartConversion(void)
+{
+	ADC1->CR1 |= ADC1_CR1_ADON;
+}
+
+uint16_t ADC1_GetConversionValue(void)
+{
+	uint8_t lsb, msb;
+
+	if (ADC1->CR2 & ADC1_CR2_ALIGN) {
+		lsb = ADC1->DRL;
+		msb = ADC1->DRH;
+		return (uint16_t)(lsb | (msb << 8));
+	}
+
+	msb = ADC1->DRH;
+	lsb = ADC1->DRL;
+	return (uint16_t)(lsb | (msb << 2));
+}
+
+void ADC1_AWDChannelConfig(ADC1_Channel_TypeDef Channel, FunctionalState NewState)
+{
+	if (Channel < 8) {
+		if (NewState != DISABLE)
+			ADC1->AWCRL |= (uint8_t)(1 << Channel);
+		else
+			ADC1->AWCRL &= (uint8_t)~(uint8_t)(1 << Channel);
+	} else {
+		if (NewState != DISABLE)
+			ADC1->AWCRH |= (uint8_t)(1 << (Channel - 8));
+		else
+			ADC1->AWCRH &= (uint8_t)~(uint8_t)(1 << (Channel - 8));
+	}
+}
+
+void ADC1_SetHighThreshold(uint16_t Threshold)
+{
+	ADC1->HTRH = (uint8_t)(Threshold >> 2);
+	ADC1->HTRL = (uint8_t)Threshold & 0x03;
+}
+
+void ADC1_SetLowThreshold(uint16_t Threshold)
+{
+	ADC1->LTRL = (uint8_t)Threshold & 0x03;
+	ADC1->LTRH = (uint8_t)(Threshold >> 2);
+}
+
+static void adc_watchdog(uint8_t channel, uint16_t value)
+{
+	uint16_t high = (uint16_t)((ADC1->HTRH << 2) | (ADC1->HTRL & 0x03));
+	uint16_t low = (uint16_t)((ADC1->LTRH << 2) | (ADC1->LTRL & 0x03));
+
+	if (value <= high && value >= low)
+		return;
+
+	// In scan mode, only the channels enabled in AWCR are guarded
+	if (ADC1->CR2 & ADC1_CR2_SCAN) {
+		uint8_t guarded = channel < 8 ? (ADC1->AWCRL >> channel) : (ADC1->AWCRH >> (channel - 8));
+		if (!(guarded & 1))
+			return;
+	}
+
+	if (channel < 8)
+		ADC1->AWSRL |= (uint8_t)(1 << channel);
+	else
+		ADC1->AWSRH |= (uint8_t)(1 << (channel - 8));
+	ADC1->CSR |= ADC1_CSR_AWD;
+}
+
+static void adc_complete(void)
+{
+	ADC1->CSR |= ADC1_CSR_EOC;
+
+	if (((ADC1->CSR & ADC1_CSR_EOCIE) && (ADC1->CSR & ADC1_CSR_EOC)) ||
+	    ((ADC1->CSR & ADC1_CSR_AWDIE) && (ADC1->CSR & ADC1_CSR_AWD)))
+		host_raise(ADC1_IRQHandler);
+}
+
+void host_adc_convert(uint16_t value)
+{
+	if (!(ADC1->CR1 & ADC1_CR1_ADON))
+		return;
+
+	if (ADC1->CR2 & ADC1_CR2_ALIGN) {
+		ADC1->DRH = (uint8_t)(value >> 8);
+		ADC1->DRL = (uint8_t)value;
+	} else {
+		ADC1->DRH = (uint8_t)(value >> 2);
+		ADC1->DRL = (uint8_t)(value << 6);
+	}
+
+	adc_watchdog(ADC1->CSR & ADC1_CSR_CH, value);
+	adc_complete();
+}
+
+void host_adc_scan(const uint16_t *values)
+{
+	volatile uint16_t *buffer = (volatile uint16_t *)&ADC1->DB0RH;
+	uint8_t last = ADC1->CSR & ADC1_CSR_CH;
+	uint8_t ch;
+
+	if (!(ADC1->CR1 & ADC1_CR1_ADON))
+		return;
+
+	for (ch = 0; ch <= last && ch < 10; ch++) {
+		buffer[ch] = values[ch]; // Host byte order (See stm8s.h)
+		adc_watchdog(ch, values[ch]);
+	}
+
+	adc_complete();
+}
+
+/* TIM1 ----------------------------------------------------------------------*/
+
+void TIM1_DeInit(void)
+{
+	uint8_t *regs = (uint8_t *)TIM1;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(*TIM1); i++)
+		regs[i] = 0;
+
+	TIM1->ARRH = TIM1->ARRL = 0xFF;
+}
+
+void TIM1_TimeBaseInit(uint16_t TIM1_Prescaler, TIM1_CounterMode_TypeDef TIM1_CounterMode,
+		       uint16_t TIM1_Period, uint8_t TIM1_RepetitionCounter)
+{
+	TIM1->ARRH = (uint8_t)(TIM1_Period >> 8);
+	TIM1->ARRL = (uint8_t)TIM1_Period;
+	TIM1->PSCRH = (uint8_t)(TIM1_Prescaler >> 8);
+	TIM1->PSCRL = (uint8_t)TIM1_Prescaler;
+	TIM1->CR1 = (uint8_t)((TIM1->CR1 & 0x8F) | TIM1_CounterMode);
+	TIM1->RCR = TIM1_RepetitionCounter;
+}
+
+void TIM1_SelectOutputTrigger(TIM1_TRGOSource_TypeDef TIM1_TRGOSource)
+{
+	TIM1->CR2 = (uint8_t)((TIM1->CR2 & ~TIM1_CR2_MMS) | TIM1_TRGOSource);
+}
+
+void TIM1_Cmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM1->CR1 |= TIM1_CR1_CEN;
+	else
+		TIM1->CR1 &= (uint8_t)(~TIM1_CR1_CEN);
+}
+
+/* TIM2 ----------------------------------------------------------------------*/
+
+void TIM2_TimeBaseInit(TIM2_Prescaler_TypeDef TIM2_Prescaler, uint16_t TIM2_Period)
+{
+	TIM2->PSCR = (uint8_t)TIM2_Prescaler;
+	TIM2->ARRH = (uint8_t)(TIM2_Period >> 8);
+	TIM2->ARRL = (uint8_t)TIM2_Period;
+}
+
+void TIM2_OC1Init(TIM2_OCMode_TypeDef TIM2_OCMode, TIM2_OutputState_TypeDef TIM2_OutputState,
+		  uint16_t TIM2_Pulse, TIM2_OCPolarity_TypeDef TIM2_OCPolarity)
+{
+	TIM2->CCER1 &= (uint8_t)(~(TIM2_CCER1_CC1E | TIM2_CCER1_CC1P));
+	TIM2->CCER1 |= (uint8_t)((TIM2_OutputState & TIM2_CCER1_CC1E) | (TIM2_OCPolarity & TIM2_CCER1_CC1P));
+	TIM2->CCMR1 = (uint8_t)((TIM2->CCMR1 & ~TIM2_CCMR_OCM) | TIM2_OCMode);
+	TIM2->CCR1H = (uint8_t)(TIM2_Pulse >> 8);
+	TIM2->CCR1L = (uint8_t)TIM2_Pulse;
+}
+
+void TIM2_OC1PreloadConfig(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM2->CCMR1 |= TIM2_CCMR_OCxPE;
+	else
+		TIM2->CCMR1 &= (uint8_t)(~TIM2_CCMR_OCxPE);
+}
+
+void TIM2_ARRPreloadConfig(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM2->CR1 |= TIM2_CR1_ARPE;
+	else
+		TIM2->CR1 &= (uint8_t)(~TIM2_CR1_ARPE);
+}
+
+void TIM2_Cmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM2->CR1 |= TIM2_CR1_CEN;
+	else
+		TIM2->CR1 &= (uint8_t)(~TIM2_CR1_CEN);
+}
+
+/* TIM4 ----------------------------------------------------------------------*/
+
+void TIM4_DeInit(void)
+{
+	uint8_t *regs = (uint8_t *)TIM4;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(*TIM4); i++)
+		regs[i] = 0;
+
+	TIM4->ARR = 0xFF;
+}
+
+void TIM4_TimeBaseInit(TIM4_Prescaler_TypeDef TIM4_Prescaler, uint8_t TIM4_Period)
+{
+	TIM4->PSCR = (uint8_t)TIM4_Prescaler;
+	TIM4->ARR = TIM4_Period;
+}
+
+void TIM4_SelectOnePulseMode(TIM4_OPMode_TypeDef TIM4_OPMode)
+{
+	if (TIM4_OPMode != TIM4_OPMODE_REPETITIVE)
+		TIM4->CR1 |= TIM4_CR1_OPM;
+	else
+		TIM4->CR1 &= (uint8_t)(~TIM4_CR1_OPM);
+}
+
+void TIM4_ITConfig(TIM4_IT_TypeDef TIM4_IT, FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM4->IER |= (uint8_t)TIM4_IT;
+	else
+		TIM4->IER &= (uint8_t)(~TIM4_IT);
+}
+
+void TIM4_ClearFlag(TIM4_FLAG_TypeDef TIM4_FLAG)
+{
+	TIM4->SR1 &= (uint8_t)(~TIM4_FLAG); // Writing 1s has no effect on the real flags
+}
+
+void TIM4_ARRPreloadConfig(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM4->CR1 |= TIM4_CR1_ARPE;
+	else
+		TIM4->CR1 &= (uint8_t)(~TIM4_CR1_ARPE);
+}
+
+void TIM4_Cmd(FunctionalState NewState)
+{
+	if (NewState != DISABLE)
+		TIM4->CR1 |= TIM4_CR1_CEN;
+	else
+		TIM4->CR1 &= (uint8_t)(~TIM4_CR1_CEN);
+}
+
+void host_tim4_overflow(void)
+{
+	if (!(TIM4->CR1 & TIM4_CR1_CEN))
+		return;
+
+	TIM4->CNTR = 0;
+	_tim4_psc = TIM4->PSCR & TIM4_PSCR_PSC;
+	_tim4_div = 0;
+	TIM4->SR1 = TIM4_SR1_UIF; // Other bits of SR1 are reserved and read as 0
+
+	if (TIM4->CR1 & TIM4_CR1_OPM)
+		TIM4->CR1 &= (uint8_t)(~TIM4_CR1_CEN);
+
+	if (TIM4->IER & TIM4_IER_UIE)
+		host_raise(TIM4_UPD_OVF_IRQHandler);
+}
+
+void host_tim4_run(uint32_t cycles)
+{
+	// A forced update (EGR UG) written since the last call
+	if (TIM4->EGR & TIM4_EGR_UG) {
+		TIM4->EGR = 0;
+		TIM4->CNTR = 0;
+		_tim4_psc = TIM4->PSCR & TIM4_PSCR_PSC;
+		_tim4_div = 0;
+	}
+
+	while (cycles-- && (TIM4->CR1 & TIM4_CR1_CEN)) {
+		if (++_tim4_div < (1 << _tim4_psc))
+			continue;
+		_tim4_div = 0;
+
+		if (TIM4->CNTR == TIM4->ARR)
+			host_tim4_overflow();
+		else
+			TIM4->CNTR++;
+	}
+}
+
+/* ITC -----------------------------------------------------------------------*/
+
+void ITC_SetSoftwarePriority(ITC_Irq_TypeDef IrqNum, ITC_PriorityLevel_TypeDef PriorityValue)
+{
+	volatile uint8_t *spr = &ITC->ISPR1 + (IrqNum / 4);
+	uint8_t shift = (uint8_t)((IrqNum % 4) * 2);
+
+	*spr = (uint8_t)((*spr & ~(0x03 << shift)) | (PriorityValue << shift));
+}
+
+ITC_PriorityLevel_TypeDef ITC_GetSoftwarePriority(ITC_Irq_TypeDef IrqNum)
+{
+	volatile uint8_t *spr = &ITC->ISPR1 + (IrqNum / 4);
+
+	return (ITC_PriorityLevel_TypeDef)((*spr >> ((IrqNum % 4) * 2)) & 0x03);
+}
+
+/* UART1 ---------------------------------------------------------------------*/
+
+// The handler reads SR and DR, which clears RXNE and OR on the real UART
+static void uart_rx_irq(void)
+{
+	UART1_RX_IRQHandler();
+	UART1->SR &= (uint8_t)(~(UART1_SR_RXNE | UART1_SR_OR));
+}
+
+void host_uart_receive(uint8_t c)
+{
+	if (!(UART1->CR2 & UART1_CR2_REN))
+		return;
+
+	if (UART1->SR & UART1_SR_RXNE) {
+		UART1->SR |= UART1_SR_OR; // Previous byte not read yet, the new one is lost
+	} else {
+		UART1->DR = c;
+		UART1->SR |= UART1_SR_RXNE;
+	}
+
+	if (UART1->CR2 & UART1_CR2_RIEN)
+		host_raise(uart_rx_irq);
+}
+
+bool host_uart_transmit(uint8_t *c)
+{
+	if (!host_interrupts_enabled || !(UART1->CR2 & UART1_CR2_TEN) || !(UART1->CR2 & UART1_CR2_TIEN))
+		return FALSE;
+
+	run_handler(UART1_TX_IRQHandler);
+
+	// The handler disables TIEN instead of writing DR once it has nothing to send
+	if (!(UART1->CR2 & UART1_CR2_TIEN))
+		return FALSE;
+
+	*c = UART1->DR;
+	return TRUE;
+}
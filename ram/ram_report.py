@@ -0,0 +1,375 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Reports the RAM usage of a firmware build and whether it
+#              fits into the 1 KB of the STM8S103F3. Globals are taken from
+#              the map file, variables at fixed addresses (__at) and the
+#              worst case stack depth from the assembler files that SDCC
+#              leaves next to the objects (See README.md).
+#
+#              Runs as a post: extra script of the firmware environment,
+#              which fails the build on an overflow unless custom_ram_fail
+#              is set to no, and can be run by hand on an existing build.
+#
+# Usage:       ram_report.py [--build-dir .pio/build/stm8sblue] [--json ram.json]
+#                            [project ...]
+
+import glob
+import inspect
+import json
+import os
+import re
+import sys
+
+RAM_DIR = os.path.dirname(os.path.abspath(inspect.getframeinfo(inspect.currentframe()).filename)) # No __file__ under SCons
+ROOT = os.path.dirname(RAM_DIR)
+
+sys.path.insert(0, os.path.join(ROOT, "bench"))
+from bench import RAM_AREAS # Same accounting as the benchmarks
+
+RAM_END = 0x0400 # STM8S103F3, RAM from 0x0000 to 0x03FF, the stack grows down from 0x03FF
+
+ISR_CONTEXT = 9 # PC, Y, X, A and CC, pushed by the CPU on interrupt entry
+
+# Return address pushed by each call instruction, tail jumps push none
+CALLS = {"call": 2, "callr": 2, "callf": 3, "jp": 0, "jpf": 0}
+
+DEFAULT_NESTING = 3		# Software priority levels 1 to 3 above the main loop at level 0
+DEFAULT_UNKNOWN_CALL = 16	# Stack assumed for functions without assembler, ex. the SDCC library
+DEFAULT_FAIL = "yes"		# An overflow fails the build
+
+class Function:
+	def __init__(self, name, module):
+		self.name = name
+		self.module = module
+		self.frame = 0		# Deepest own stack use, in bytes
+		self.calls = []		# (depth at the call, callee or None if indirect, return address bytes)
+		self.isr = False
+
+def parse_map(path):
+	"""Returns {area: (address, size)} from an SDCC (sdld) map file"""
+	areas = {}
+	area_re = re.compile(r"^(\w+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+=\s+(\d+)\.\s+bytes")
+
+	with open(path) as f:
+		for line in f:
+			m = area_re.match(line)
+			if m:
+				areas.setdefault(m.group(1), (int(m.group(2), 16), int(m.group(4))))
+
+	return areas
+
+def parse_number(s):
+	s = s.strip().lstrip("#")
+	return int(s, 16) if s.lower().startswith("0x") else int(s)
+
+def parse_asm(paths):
+	"""Returns (functions, variables, absolute, address_taken) of SDCC stm8
+	   assembler files. variables holds (module, name, area, size) of every
+	   variable in RAM, absolute (name, address, size) of every variable at
+	   a fixed address, address_taken the functions whose address is used
+	   as a value, ie. that may be called through a pointer."""
+	functions = {}
+	variables = []
+	absolute = []
+	address_taken = set()
+	isr_names = set()
+
+	label_re = re.compile(r"^([A-Za-z_][\w$]*)::?")
+	insn_re = re.compile(r"^\s+([\.\w]+)\s*(.*)$")
+	ref_re = re.compile(r"(?:#\(?\s*|\.dw\s+#?)(_\w+)")
+
+	for path in paths:
+		module = os.path.splitext(os.path.basename(path))[0]
+		area = None
+		func = None
+		depth = 0
+		var = None
+		org = None
+
+		with open(path) as f:
+			for line in f:
+				line = line.split(";", 1)[0].rstrip()
+				if not line:
+					continue
+
+				m = label_re.match(line)
+				if m:
+					name = m.group(1)
+					if area == "CODE":
+						func = Function(name, module)
+						functions[name] = func
+						depth = 0
+					elif area in RAM_AREAS or area == "DABS":
+						var = name
+					continue
+
+				m = insn_re.match(line)
+				if not m:
+					continue
+
+				op = m.group(1).lower()
+				arg = m.group(2).strip()
+
+				if op == ".area":
+					area = arg.split()[0]
+					func = None
+					var = None
+					continue
+
+				for ref in ref_re.findall(line):
+					address_taken.add(ref)
+
+				if op == ".org":
+					org = parse_number(arg)
+				elif op == ".ds" and var is not None:
+					size = parse_number(arg)
+					if area == "DABS" and org is not None:
+						absolute.append((var, org, size))
+						org += size
+					elif area in RAM_AREAS:
+						variables.append((module, var, area, size))
+					var = None
+				elif op == "int":
+					isr_names.add(arg.split()[0]) # Vector table entry
+				elif func is None:
+					continue
+				elif op == "push":
+					depth += 1
+				elif op == "pushw":
+					depth += 2
+				elif op == "pop":
+					depth -= 1
+				elif op == "popw":
+					depth -= 2
+				elif op == "sub" and arg.replace(" ", "").startswith("sp,"):
+					depth += parse_number(arg.split(",", 1)[1])
+				elif op == "addw" and arg.replace(" ", "").startswith("sp,"):
+					depth -= parse_number(arg.split(",", 1)[1])
+				elif op in CALLS:
+					target = arg.split()[0] if arg else ""
+					if re.match(r"^_\w+$", target): # Local labels (00101$) are jumps within the function
+						func.calls.append((depth, target, CALLS[op]))
+					elif op.startswith("call"):
+						func.calls.append((depth, None, CALLS[op])) # Through a pointer
+				elif op == "iret":
+					func.isr = True
+
+				if func is not None:
+					depth = max(depth, 0) # Linear scan, never trust a branch to unbalance below zero
+					func.frame = max(func.frame, depth)
+
+	for name in isr_names:
+		if name in functions:
+			functions[name].isr = True
+
+	return functions, variables, absolute, address_taken
+
+class StackAnalysis:
+	def __init__(self, functions, address_taken, unknown_call):
+		self.functions = functions
+		self.unknown_call = unknown_call
+		self.unknown = set()	# Callees without assembler
+		self.recursive = set()
+		self.indirect = sorted(n for n in address_taken if n in functions and not functions[n].isr)
+		self._worst = {}
+		self._active = set()
+
+	def worst(self, name):
+		"""Deepest stack use of a function including its callees, without
+		   the return address of the call into it"""
+		if name in self._worst:
+			return self._worst[name]
+
+		func = self.functions.get(name)
+		if func is None:
+			self.unknown.add(name)
+			return self.unknown_call
+
+		if name in self._active:
+			self.recursive.add(name)
+			return 0 # Counted once, the recursion depth is not known
+
+		self._active.add(name)
+
+		worst = func.frame
+		for depth, callee, ret in func.calls:
+			if callee is None:
+				targets = [self.worst(n) for n in self.indirect]
+				callee_worst = max(targets) if targets else self.unknown_call
+			else:
+				callee_worst = self.worst(callee)
+			worst = max(worst, depth + ret + callee_worst)
+
+		self._active.discard(name)
+		self._worst[name] = worst
+		return worst
+
+def analyze(map_path, asm_paths, nesting=DEFAULT_NESTING, unknown_call=DEFAULT_UNKNOWN_CALL):
+	"""Returns the RAM report of a build as a dict. "errors" lists every
+	   reason why the firmware does not fit."""
+	areas = parse_map(map_path)
+	functions, variables, absolute, address_taken = parse_asm(asm_paths)
+
+	report = {"errors": [], "warnings": []}
+
+	if not any(a in areas for a in RAM_AREAS):
+		report["warnings"].append("no %s area in the map file, globals not counted" % " or ".join(RAM_AREAS))
+
+	# Globals
+	ranges = [(addr, addr + size) for name, (addr, size) in areas.items() if name in RAM_AREAS and size]
+	globals_start = min((r[0] for r in ranges), default=0)
+	globals_end = max((r[1] for r in ranges), default=0)
+	report["globals"] = sum(areas.get(a, (0, 0))[1] for a in RAM_AREAS)
+	report["globals_range"] = [globals_start, globals_end]
+
+	modules = {}
+	for module, name, area, size in variables:
+		modules[module] = modules.get(module, 0) + size
+	report["modules"] = modules
+
+	# Variables at fixed addresses, ex. the spurious interrupt log
+	report["absolute"] = [{"name": n, "address": a, "size": s} for n, a, s in absolute]
+	occupied = globals_end
+	for name, addr, size in absolute:
+		if addr < globals_end and addr + size > globals_start:
+			report["errors"].append("globals (0x%04X-0x%04X) overlap %s (0x%04X-0x%04X)" %
+						(globals_start, globals_end - 1, name, addr, addr + size - 1))
+		if addr + size > RAM_END:
+			report["errors"].append("%s (0x%04X-0x%04X) lies outside of RAM" % (name, addr, addr + size - 1))
+		occupied = max(occupied, addr + size)
+
+	# Stack, from the top of RAM down to the highest byte in use
+	report["stack_room"] = max(RAM_END - occupied, 0)
+
+	if not functions:
+		report["warnings"].append("no assembler files found, stack not analyzed")
+		report["stack"] = None
+		return report
+
+	if "_main" not in functions:
+		report["warnings"].append("no _main in the assembler files, stack not analyzed")
+		report["stack"] = None
+		return report
+
+	stack = StackAnalysis(functions, address_taken, unknown_call)
+
+	main_stack = stack.worst("_main") # Entered by a jp from the startup code, no return address
+	isrs = sorted(((ISR_CONTEXT + stack.worst(f.name), f.name) for f in functions.values() if f.isr), reverse=True)
+	nested = isrs[:nesting]
+
+	report["stack"] = main_stack + sum(s for s, n in nested)
+	report["stack_main"] = main_stack
+	report["stack_isrs"] = [{"name": n, "size": s} for s, n in nested]
+
+	if stack.unknown:
+		report["warnings"].append("assumed %d bytes of stack for %s" % (unknown_call, ", ".join(sorted(stack.unknown))))
+	if stack.recursive:
+		report["warnings"].append("recursion through %s, counted once" % ", ".join(sorted(stack.recursive)))
+
+	if report["stack"] > report["stack_room"]:
+		report["errors"].append("worst case stack of %d bytes exceeds the %d bytes above 0x%04X" %
+					(report["stack"], report["stack_room"], occupied - 1 if occupied else 0))
+
+	return report
+
+def print_report(name, report, out=sys.stdout):
+	start, end = report["globals_range"]
+
+	out.write("RAM usage of %s (%d bytes)\n" % (name, RAM_END))
+	out.write("  %-10s %5d B" % ("globals", report["globals"]))
+	if end:
+		out.write("  0x%04X-0x%04X" % (start, end - 1))
+	out.write("\n")
+
+	for module, size in sorted(report["modules"].items(), key=lambda m: -m[1]):
+		out.write("    %-20s %5d B\n" % (module, size))
+
+	for a in report["absolute"]:
+		out.write("  %-10s %5d B  0x%04X-0x%04X  %s\n" % ("fixed", a["size"], a["address"], a["address"] + a["size"] - 1, a["name"]))
+
+	if report["stack"] is None:
+		out.write("  %-10s     ? B  of %d B\n" % ("stack", report["stack_room"]))
+	else:
+		isrs = " + ".join("%s %d" % (i["name"], i["size"]) for i in report["stack_isrs"])
+		out.write("  %-10s %5d B  of %d B, main %d%s\n" % ("stack", report["stack"], report["stack_room"],
+								report["stack_main"], " + " + isrs if isrs else ""))
+
+	for w in report["warnings"]:
+		out.write("  warning: %s\n" % w)
+	for e in report["errors"]:
+		out.write("  error: %s\n" % e)
+
+def find_asm(build_dir):
+	return sorted(glob.glob(os.path.join(build_dir, "**", "*.asm"), recursive=True))
+
+def main():
+	import argparse
+
+	parser = argparse.ArgumentParser(description="Report the RAM usage of the example projects")
+	parser.add_argument("projects", nargs="*", help="Projects to report (Default: all built ones)")
+	parser.add_argument("--build-dir", default=os.path.join(".pio", "build", "stm8sblue"), help="Build directory, relative to each project")
+	parser.add_argument("--nesting", type=int, default=DEFAULT_NESTING, help="Interrupt handlers that may nest")
+	parser.add_argument("--unknown-call", type=int, default=DEFAULT_UNKNOWN_CALL, help="Stack assumed for functions without assembler")
+	parser.add_argument("--json", help="Also write the reports to this JSON file")
+	args = parser.parse_args()
+
+	projects = args.projects or sorted(d for d in os.listdir(ROOT)
+					   if os.path.exists(os.path.join(ROOT, d, args.build_dir, "firmware.map")))
+	if not projects:
+		sys.exit("error: no builds found, run pio run first")
+
+	reports = {}
+	failed = False
+	for project in projects:
+		build_dir = os.path.join(ROOT, project, args.build_dir)
+		map_path = os.path.join(build_dir, "firmware.map")
+		if not os.path.exists(map_path):
+			sys.exit("error: %s not found, run pio run first" % map_path)
+
+		reports[project] = analyze(map_path, find_asm(build_dir), args.nesting, args.unknown_call)
+
+		print_report(project, reports[project])
+		failed |= bool(reports[project]["errors"])
+
+	if args.json:
+		with open(args.json, "w") as f:
+			json.dump(reports, f, indent=2, sort_keys=True)
+
+	return 1 if failed else 0
+
+if __name__ == "__main__":
+	sys.exit(main())
+elif "Import" in globals(): # PlatformIO extra script
+	Import("env")
+
+	def ram_report(target, source, env):
+		build_dir = env.subst("$BUILD_DIR")
+		fail = env.GetProjectOption("custom_ram_fail", DEFAULT_FAIL).lower() in ("yes", "true", "1")
+
+		try:
+			report = analyze(os.path.join(build_dir, "firmware.map"), find_asm(build_dir),
+					 int(env.GetProjectOption("custom_ram_nesting", str(DEFAULT_NESTING))),
+					 int(env.GetProjectOption("custom_ram_unknown_call", str(DEFAULT_UNKNOWN_CALL))))
+		except (OSError, ValueError) as e: # A map or assembler file it cannot read is no overflow
+			sys.stderr.write("Warning: RAM report: %s\n" % e)
+			return 0
+
+		print_report(os.path.basename(env.subst("$PROJECT_DIR")), report)
+		return 1 if fail and report["errors"] else 0 # Non-zero fails the build
+
+	env.AddPostAction("$BUILD_DIR/${PROGNAME}${PROGSUFFIX}", ram_report)
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Reports the flash usage of every project with three SPL
+#              configurations: all STM8S103 drivers enabled, as the stock
+#              stm8s_conf.h template would have it, the modules declared in
+#              custom_spl_modules, and the declared modules without
+#              USE_FULL_ASSERT. Sizes are taken from the map file.
+#
+# Usage:       size_report.py [--json sizes.json] [project ...]
+#
+# Requires:    PlatformIO (pio) in PATH
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+import spl_conf
+
+sys.path.insert(0, os.path.join(spl_conf.ROOT, "bench"))
+from bench import parse_map, FLASH_AREAS # Same accounting as the benchmarks
+
+FLASH_SIZE = 8192 # STM8S103F3
+
+BUILD_DIR = os.path.join(".pio", "spl_size") # Keeps the regular build untouched
+
+# Variant name and the project options it overrides
+VARIANTS = (
+	("all",      ["custom_spl_modules=all"]),
+	("declared", []),
+	("no_assert", ["custom_spl_full_assert=no"]),
+)
+
+class SizeError(Exception):
+	pass
+
+def flash_size(project, variant, options, pio):
+	env = dict(os.environ)
+	env["PLATFORMIO_BUILD_DIR"] = os.path.join(BUILD_DIR, variant)
+
+	cmd = [pio, "run", "-d", os.path.join(spl_conf.ROOT, project), "-e", "stm8sblue"]
+	for opt in options:
+		cmd += ["-O", opt]
+
+	proc = subprocess.run(cmd, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+			      universal_newlines=True)
+	if proc.returncode != 0:
+		sys.stderr.write(proc.stdout)
+		raise SizeError("build of %s (%s) failed" % (project, variant))
+
+	maps = glob.glob(os.path.join(spl_conf.ROOT, project, BUILD_DIR, variant, "*", "firmware.map"))
+	if not maps:
+		raise SizeError("no firmware.map found for %s (%s)" % (project, variant))
+
+	areas, _ = parse_map(maps[0])
+	return sum(areas.get(a, 0) for a in FLASH_AREAS)
+
+def measure(project, pio):
+	# The variants regenerate src/stm8s_conf.h, restore the declared one afterwards
+	conf = os.path.join(spl_conf.ROOT, project, "src", "stm8s_conf.h")
+	with open(conf, "rb") as f:
+		saved = f.read()
+
+	try:
+		return {variant: flash_size(project, variant, options, pio) for variant, options in VARIANTS}
+	finally:
+		with open(conf, "wb") as f:
+			f.write(saved)
+
+def print_sizes(sizes):
+	print("%-22s %8s %8s %8s %8s %8s" % ("project", "all", "declared", "saved", "no_assert", "saved"))
+	for project, s in sizes.items():
+		print("%-22s %8d %8d %8d %8d %8d" % (project, s["all"], s["declared"], s["all"] - s["declared"],
+						      s["no_assert"], s["declared"] - s["no_assert"]))
+	print("Flash bytes, of %d available" % FLASH_SIZE)
+
+def main():
+	parser = argparse.ArgumentParser(description="Report the flash saved by the per-project SPL configuration")
+	parser.add_argument("projects", nargs="*", help="Projects to measure (Default: all with custom_spl_modules)")
+	parser.add_argument("--json", help="Also write the sizes to this JSON file")
+	parser.add_argument("--pio", default="pio", help="PlatformIO executable")
+	args = parser.parse_args()
+
+	if shutil.which(args.pio) is None:
+		sys.exit("error: %s not found in PATH" % args.pio)
+
+	projects = args.projects or sorted(d for d in os.listdir(spl_conf.ROOT)
+					   if os.path.exists(os.path.join(spl_conf.ROOT, d, "platformio.ini"))
+					   and spl_conf.project_options(d) is not None)
+
+	sizes = {}
+	try:
+		for project in projects:
+			sizes[project] = measure(project, args.pio)
+	except SizeError as e:
+		sys.exit("error: %s" % e)
+
+	print_sizes(sizes)
+
+	if args.json:
+		with open(args.json, "w") as f:
+			json.dump(sizes, f, indent=2, sort_keys=True)
+
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main())
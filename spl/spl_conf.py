@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Description: Generates src/stm8s_conf.h of a project from the shared
+#              stm8s_conf.h.in template and the SPL modules listed in
+#              custom_spl_modules of its platformio.ini. The SPL builder of
+#              PlatformIO derives the driver sources it compiles from the
+#              headers included by stm8s_conf.h, so only those modules are
+#              built and linked.
+#
+#              Runs as a pre: extra script of the firmware environment, and
+#              can be run by hand to regenerate or check all projects.
+#
+# Usage:       spl_conf.py [--check] [project ...]
+
+import configparser
+import inspect
+import os
+import sys
+
+SPL_DIR = os.path.dirname(os.path.abspath(inspect.getframeinfo(inspect.currentframe()).filename)) # No __file__ under SCons
+ROOT = os.path.dirname(SPL_DIR)
+TEMPLATE = os.path.join(SPL_DIR, "stm8s_conf.h.in")
+
+# SPL drivers available on the STM8S103
+MODULES = ("adc1", "awu", "beep", "clk", "exti", "flash", "gpio", "i2c", "itc",
+	   "iwdg", "rst", "spi", "tim1", "tim2", "tim4", "uart1", "wwdg")
+
+class SplConfError(Exception):
+	pass
+
+def parse_modules(value):
+	"""Returns the modules of a custom_spl_modules value in canonical order"""
+	names = value.replace(",", " ").lower().split()
+
+	if names == ["all"]:
+		return list(MODULES)
+
+	for name in names:
+		if name not in MODULES:
+			raise SplConfError("unknown SPL module '%s', expected one of: %s" % (name, " ".join(MODULES)))
+
+	return [m for m in MODULES if m in names]
+
+def parse_bool(value):
+	if value.strip().lower() in ("1", "yes", "true", "on"):
+		return True
+	if value.strip().lower() in ("0", "no", "false", "off"):
+		return False
+	raise SplConfError("custom_spl_full_assert must be yes or no, got '%s'" % value)
+
+def render(modules, full_assert):
+	with open(TEMPLATE) as f:
+		conf = f.read()
+
+	includes = "\n".join('#include "stm8s_%s.h"' % m for m in modules)
+	conf = conf.replace("@SPL_INCLUDES@", includes)
+	conf = conf.replace("@SPL_FULL_ASSERT@", "#define USE_FULL_ASSERT    (1) " if full_assert else "// #define USE_FULL_ASSERT    (1)")
+
+	return conf
+
+def write_conf(src_dir, modules, full_assert, check=False):
+	"""Writes src_dir/stm8s_conf.h if its content changed, so an unchanged
+	   configuration does not trigger a rebuild. Returns True if the file
+	   was (or, with check set, would have been) changed."""
+	path = os.path.join(src_dir, "stm8s_conf.h")
+	conf = render(modules, full_assert)
+
+	try:
+		with open(path, newline="") as f:
+			if f.read() == conf:
+				return False
+	except FileNotFoundError:
+		pass
+
+	if not check:
+		with open(path, "w", newline="") as f:
+			f.write(conf)
+
+	return True
+
+def project_options(project):
+	"""Returns (modules, full_assert) of the first environment of a project
+	   that sets custom_spl_modules, or None if there is none"""
+	ini = configparser.ConfigParser()
+	ini.read(os.path.join(ROOT, project, "platformio.ini"))
+
+	for section in ini.sections():
+		if ini.has_option(section, "custom_spl_modules"):
+			return (parse_modules(ini.get(section, "custom_spl_modules")),
+				parse_bool(ini.get(section, "custom_spl_full_assert", fallback="yes")))
+
+	return None
+
+def main():
+	import argparse
+
+	parser = argparse.ArgumentParser(description="Generate src/stm8s_conf.h of the example projects")
+	parser.add_argument("projects", nargs="*", help="Projects to generate (Default: all)")
+	parser.add_argument("--check", action="store_true", help="Only report out of date headers, exit with 1 if any")
+	args = parser.parse_args()
+
+	projects = args.projects or sorted(d for d in os.listdir(ROOT) if os.path.exists(os.path.join(ROOT, d, "platformio.ini")))
+
+	stale = []
+	try:
+		for project in projects:
+			opts = project_options(project)
+			if opts is None:
+				print("%s: no custom_spl_modules, skipped" % project)
+				continue
+			if write_conf(os.path.join(ROOT, project, "src"), opts[0], opts[1], args.check):
+				stale.append(project)
+				print("%s: %s" % (project, "out of date" if args.check else "updated"))
+	except SplConfError as e:
+		sys.exit("error: %s" % e)
+
+	return 1 if args.check and stale else 0
+
+if __name__ == "__main__":
+	sys.exit(main())
+elif "Import" in globals(): # PlatformIO extra script, not imported by size_report.py
+	Import("env")
+
+	try:
+		write_conf(env.subst("$PROJECT_SRC_DIR"),
+			   parse_modules(env.GetProjectOption("custom_spl_modules")),
+			   parse_bool(env.GetProjectOption("custom_spl_full_assert", "yes")))
+	except SplConfError as e:
+		sys.stderr.write("Error: %s\n" % e)
+		env.Exit(1)
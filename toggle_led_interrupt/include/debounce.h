@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Timer based button debouncing for the toggle_led_interrupt
+ * 		example
+ */
+
+#ifndef _DEBOUNCE_H_INCLUDED_
+#define _DEBOUNCE_H_INCLUDED_
+
+#include <stm8s.h>
+
+#ifndef F_CPU
+#error "F_CPU not defined"
+#endif
+
+// Time after an edge during which the button is ignored
+#ifndef DEBOUNCE_MS
+#define DEBOUNCE_MS 10
+#endif
+
+void debounce_init(void);
+
+// Called from EXTI_PORTD_IRQHandler (See stm8s_it.c)
+void debounce_edge_isr(void);
+
+// Called from TIM4_UPD_OVF_IRQHandler (See stm8s_it.c)
+// Returns TRUE if the lockout has ended with the button released
+bool debounce_timer_isr(void);
+
+#endif /* _DEBOUNCE_H_INCLUDED_ */
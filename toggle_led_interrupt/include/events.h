@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Event queues from the interrupt handlers to the main loop
+ * 		of the toggle_led_interrupt example
+ */
+
+#ifndef _EVENTS_H_INCLUDED_
+#define _EVENTS_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Event codes, index into the handler table passed to events_dispatch()
+#define EVENT_BUTTON 0	// Button released and settled (See debounce.c)
+#define EVENT_WAKE   1	// Periodic wake up in active-halt (See power.c)
+#define EVENT_CODES  2
+
+// Every interrupt handler that posts events has a queue of its own, so
+// each queue is only ever written by one handler and read by the main
+// loop, whatever the priorities of the handlers (See events.c)
+#define EVENT_SOURCE_TIM4 0	// TIM4_UPD_OVF_IRQHandler
+#define EVENT_SOURCE_AWU  1	// AWU_IRQHandler
+#define EVENT_SOURCES     2
+
+// Events per queue, a power of two up to 128
+#ifndef EVENTS_QUEUE_SIZE
+#define EVENTS_QUEUE_SIZE 4
+#endif
+
+typedef struct {
+	uint8_t code;	// EVENT_*
+	uint16_t stamp;	// TIM2 count (fCPU) at the time of posting, see events_now()
+} event_t;
+
+typedef void (*event_handler_t)(const event_t *event);
+
+// Dropped events per source, as their queue was full. Saturates at 255.
+// Read through a debugger memory dump or the simulator.
+extern volatile uint8_t events_dropped[EVENT_SOURCES];
+
+void events_init(void); // Starts TIM2, call before enabling interrupts
+
+// Called from interrupt handlers, posts an event to the queue of source
+void events_post(uint8_t source, uint8_t code);
+
+// Called from the main loop. Takes the next event off the queues, the one
+// of the lowest source first, and runs its handler, if the table has one.
+// Returns FALSE if all queues were empty.
+bool events_dispatch(const event_handler_t handlers[EVENT_CODES]);
+
+// TRUE if an event waits for dispatch. Check with interrupts disabled
+// before going to sleep, so no post slips in between check and sleep.
+bool events_pending(void);
+
+// Current TIM2 count, to compare against the stamp of an event. TIM2
+// stops while the core halts, so the difference is the time spent awake.
+uint16_t events_now(void);
+
+#endif /* _EVENTS_H_INCLUDED_ */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Opt-in per interrupt vector statistics for the
+ * 		toggle_led_interrupt example
+ */
+
+#ifndef _ISR_STATS_H_INCLUDED_
+#define _ISR_STATS_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Define ISR_STATS to have every handler in stm8s_it.c record how often it
+// fires and how many TIM2 ticks (fCPU) it runs, as well as how deep
+// handlers nest. Read the isr_stats, isr_depth and isr_max_depth variables
+// through a debugger memory dump or the simulator (See README.md).
+// Without ISR_STATS, ISR_ENTER() and ISR_EXIT() expand to nothing and
+// neither RAM nor TIM2 is used.
+
+#define ISR_STATS_VECTORS 26	// IRQ0 to IRQ24, and the TRAP instruction
+#define ISR_TRAP          25	// Index of the TRAP handler
+#define ISR_STATS_DEPTH   4	// TLI, plus one per software priority level (See section 6 of RM0016)
+
+typedef struct {
+	uint16_t count;	// Times the handler ran, wraps around
+	uint16_t max;	// Longest run in TIM2 ticks, excluding nested handlers
+	uint32_t total;	// Sum of all runs in TIM2 ticks, excluding nested handlers
+} isr_stat_t;
+
+#ifdef ISR_STATS
+extern volatile isr_stat_t isr_stats[ISR_STATS_VECTORS];
+extern volatile uint8_t isr_depth;	// Handlers currently running
+extern volatile uint8_t isr_max_depth;	// Deepest nesting seen
+
+void isr_stats_init(void);	// Starts TIM2, call before enabling interrupts
+void isr_stats_reset(void);	// Clears all statistics, may be called from the main loop
+void isr_stats_enter(void);
+void isr_stats_exit(uint8_t vector);
+
+#define ISR_STATS_INIT()	isr_stats_init()
+#define ISR_ENTER()		isr_stats_enter()	// First statement of a handler
+#define ISR_EXIT(vector)	isr_stats_exit(vector)	// Last statement of a handler
+#else
+#define ISR_STATS_INIT()
+#define ISR_ENTER()
+#define ISR_EXIT(vector)
+#endif
+
+#endif /* _ISR_STATS_H_INCLUDED_ */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Interrupt latency demonstration for the priority table
+ * 		(See itc_priorities.h)
+ */
+
+#ifndef _ITC_DEMO_H_INCLUDED_
+#define _ITC_DEMO_H_INCLUDED_
+
+#include <stm8s.h>
+#include <power.h>
+
+// Define ITC_DEMO to run a fast TIM2 tick next to a slow TIM1 handler. The
+// tick handler records how many cycles passed between the update event and
+// its first instruction. Without priorities, the tick has to wait whenever
+// it fires while the slow handler runs. With the priority table, it
+// pre-empts the slow handler. Build once with -D ITC_PRIORITIES=0 and once
+// without to compare itc_demo_latency_max.
+#ifdef ITC_DEMO
+
+#if IDLE_MODE != IDLE_WFI
+#error ITC_DEMO requires IDLE_MODE=IDLE_WFI, halt stops the timers!
+#endif
+
+#if defined(POWER_STATS) || defined(ISR_STATS) || defined(SPURIOUS_SELFTEST)
+#error ITC_DEMO uses TIM2 itself!
+#endif
+
+#define ITC_DEMO_TICK_CYCLES 2000	// Period of the fast tick
+#define ITC_DEMO_SLOW_PERIOD 20011	// Period of the slow handler, not a multiple of the tick so their phase drifts
+#define ITC_DEMO_SLOW_CYCLES 1500	// Time the slow handler keeps the core busy
+
+extern volatile uint16_t itc_demo_ticks;	// Fast ticks served
+extern volatile uint16_t itc_demo_latency;	// Cycles from the last update event to the tick handler
+extern volatile uint16_t itc_demo_latency_max;	// Worst case so far
+
+void itc_demo_init(void);
+
+// Called from TIM2_UPD_OVF_BRK_IRQHandler and TIM1_UPD_OVF_TRG_BRK_IRQHandler (See stm8s_it.c)
+void itc_demo_tick_isr(void);
+void itc_demo_slow_isr(void);
+
+#define ITC_DEMO_INIT() itc_demo_init()
+#else
+#define ITC_DEMO_INIT()
+#endif
+
+#endif /* _ITC_DEMO_H_INCLUDED_ */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Low power idle modes for the toggle_led_interrupt example
+ */
+
+#ifndef _POWER_H_INCLUDED_
+#define _POWER_H_INCLUDED_
+
+#include <stm8s.h>
+
+// Idle modes
+#define IDLE_WFI         0 // Wait for interrupt: CPU stopped, peripherals and clocks keep running
+#define IDLE_HALT        1 // Halt: All clocks stopped, only external interrupts wake the core
+#define IDLE_ACTIVE_HALT 2 // Active-halt: As halt, but the AWU additionally wakes the core periodically
+
+// Can be overridden through the build_flags option in platformio.ini
+#ifndef IDLE_MODE
+#define IDLE_MODE IDLE_HALT
+#endif
+
+// Auto wake up period in active-halt mode
+#ifndef AWU_TIMEBASE
+#define AWU_TIMEBASE AWU_TIMEBASE_1S
+#endif
+
+void power_init(void);
+void power_idle(void); // Sleeps until the next interrupt
+
+// While set, power_idle() falls back to wfi, ex. to keep a timer running
+// that halt would otherwise stop. May be called from ISRs.
+void power_keep_clocks(bool keep);
+
+// Called from AWU_IRQHandler (See stm8s_it.c)
+void power_awu_isr(void);
+
+// Define POWER_STATS to count wake ups and the TIM2 ticks (fCPU) the core
+// spends awake, from the first ISR after a wake up until it goes back to
+// sleep. Read both through a debugger memory dump or the simulator. TIM2
+// overflows are counted by its update interrupt, so an awake period may
+// be longer than 65535 ticks.
+#ifdef POWER_STATS
+extern volatile uint16_t power_wakeups;
+extern volatile uint32_t power_awake_ticks;
+
+void power_wake(void);
+void power_tim2_isr(void); // Called from TIM2_UPD_OVF_BRK_IRQHandler (See stm8s_it.c)
+#define POWER_WAKE() power_wake() // Place at the start of every ISR that may wake the core
+#else
+#define POWER_WAKE()
+#endif
+
+#endif /* _POWER_H_INCLUDED_ */
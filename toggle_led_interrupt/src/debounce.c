@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the timer based button debouncing
+ *
+ * A bouncing switch produces a burst of edges on every press and release.
+ * Rather than reacting to each of them, the first edge masks the button's
+ * external interrupt and starts TIM4 in one-pulse mode. Any further bounces
+ * during the lockout never reach the CPU. Once TIM4 overflows, the button
+ * level is sampled: if it is still released, the edge was real and exactly
+ * one event is reported. Either way, the button interrupt is unmasked again.
+ */
+
+#include <debounce.h>
+#include <pins.h>
+#include <gpio_fast.h>
+#include <power.h>
+
+// TIM4 counts at fCPU/128, the lockout must fit into its 8-bit counter
+#define LOCKOUT_TICKS (F_CPU / 128UL * DEBOUNCE_MS / 1000UL)
+
+#if LOCKOUT_TICKS < 1 || LOCKOUT_TICKS > 256
+#error DEBOUNCE_MS out of range for F_CPU!
+#endif
+
+void debounce_init(void)
+{
+	TIM4_DeInit();
+	TIM4_TimeBaseInit(TIM4_PRESCALER_128, LOCKOUT_TICKS - 1);
+	TIM4_SelectOnePulseMode(TIM4_OPMODE_SINGLE);	// Stop counting after the first overflow
+	TIM4->EGR = TIM4_EGR_UG;			// Load the prescaler now, the first lockout would count at fCPU/1 otherwise
+	TIM4_ClearFlag(TIM4_FLAG_UPDATE);		// The forced update is not the end of a lockout
+	TIM4_ITConfig(TIM4_IT_UPDATE, ENABLE);		// Raise TIM4_UPD_OVF_IRQHandler once the lockout is over
+}
+
+void debounce_edge_isr(void)
+{
+	BUTTON_PORT->CR2 &= (uint8_t)(~BUTTON_PIN);	// Mask button interrupt for the lockout
+	TIM4->CR1 |= TIM4_CR1_CEN;			// Start lockout
+	power_keep_clocks(TRUE);			// TIM4 must keep running, so no halt
+}
+
+bool debounce_timer_isr(void)
+{
+	TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF);		// Clear update flag
+	BUTTON_PORT->CR2 |= BUTTON_PIN;			// Unmask button interrupt
+	power_keep_clocks(FALSE);
+
+	return GPIO_READ(BUTTON_PORT, BUTTON_PIN) != 0;	// Released, as expected after a rising edge
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the event queues
+ *
+ * The interrupt handlers only record what happened, the main loop acts
+ * on it. A handler then takes the same few dozen cycles however much the
+ * application does in response, and does not hold up other interrupts
+ * of its level while doing so.
+ *
+ * Each queue is a ring of EVENTS_QUEUE_SIZE events with two free-running
+ * 8-bit indices. The head is only written by the posting handler, after
+ * the event itself, and the tail only by the main loop, after it has
+ * copied the event out. The STM8 reads and writes single bytes in one
+ * instruction, so either side always sees a complete index of the other
+ * and neither side needs to disable interrupts.
+ *
+ * Several handlers must not share a queue: with the priority table (See
+ * itc_priorities.c), the TIM4 handler can interrupt the AWU handler, and
+ * two handlers posting to the same queue could then claim the same slot.
+ * One queue per source keeps a single writer per index instead.
+ *
+ * The stamps are taken from TIM2, which runs freely at fCPU as it does
+ * for POWER_STATS and ISR_STATS. ITC_DEMO and SPURIOUS_SELFTEST reprogram
+ * TIM2, so the stamps wrap much earlier in those builds.
+ */
+
+#include <events.h>
+
+#if EVENTS_QUEUE_SIZE < 1 || EVENTS_QUEUE_SIZE > 128 || (EVENTS_QUEUE_SIZE & (EVENTS_QUEUE_SIZE - 1))
+#error EVENTS_QUEUE_SIZE must be a power of two up to 128!
+#endif
+
+typedef struct {
+	event_t events[EVENTS_QUEUE_SIZE];
+	volatile uint8_t head;	// Next event to write, only written by the source
+	volatile uint8_t tail;	// Next event to read, only written by the main loop
+} event_queue_t;
+
+volatile uint8_t events_dropped[EVENT_SOURCES];
+
+static event_queue_t _queues[EVENT_SOURCES];
+
+uint16_t events_now(void)
+{
+	uint8_t msb, lsb;
+
+	// Reading the MSB latches the LSB. A handler reading the counter in
+	// between releases the latch, so retry if the MSB moved meanwhile.
+	do {
+		msb = TIM2->CNTRH;
+		lsb = TIM2->CNTRL;
+	} while (msb != TIM2->CNTRH);
+
+	return ((uint16_t)msb << 8) | lsb;
+}
+
+void events_init(void)
+{
+	TIM2->PSCR = 0;			// Count at fCPU
+	TIM2->CR1 |= TIM2_CR1_CEN;	// Free-running up to 0xFFFF
+}
+
+void events_post(uint8_t source, uint8_t code)
+{
+	event_queue_t *q = &_queues[source];
+	uint8_t head = q->head;
+	event_t *e;
+
+	if ((uint8_t)(head - q->tail) == EVENTS_QUEUE_SIZE) {
+		if (events_dropped[source] != 0xFF)
+			events_dropped[source]++;
+		return;
+	}
+
+	e = &q->events[head & (EVENTS_QUEUE_SIZE - 1)];
+	e->code = code;
+	e->stamp = events_now();
+
+	q->head = head + 1; // Publish, the event is complete
+}
+
+bool events_dispatch(const event_handler_t handlers[EVENT_CODES])
+{
+	event_queue_t *q;
+	event_t e;
+	uint8_t tail;
+	uint8_t i;
+
+	for (i = 0; i < EVENT_SOURCES; i++) {
+		q = &_queues[i];
+		tail = q->tail;
+
+		if (tail == q->head)
+			continue;
+
+		e = q->events[tail & (EVENTS_QUEUE_SIZE - 1)];
+		q->tail = tail + 1; // Release the slot before the handler runs
+
+		if (e.code < EVENT_CODES && handlers[e.code])
+			handlers[e.code](&e);
+
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+bool events_pending(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < EVENT_SOURCES; i++) {
+		if (_queues[i].tail != _queues[i].head)
+			return TRUE;
+	}
+
+	return FALSE;
+}
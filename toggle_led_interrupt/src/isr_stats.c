@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the per interrupt vector statistics
+ *
+ * TIM2 runs freely at fCPU, the same way it does for POWER_STATS, so both
+ * can be enabled at once. A handler's run time is the difference between
+ * the counter at ISR_ENTER() and ISR_EXIT(). If a handler of higher
+ * priority interrupts it, the nested handler's run time is added to
+ * _nested[] of the interrupted level and subtracted from the interrupted
+ * handler once it exits, so every tick is accounted to exactly one vector.
+ *
+ * Both functions run with interrupts masked (See critical.h), otherwise a
+ * nested handler could slip in between reading the counter and updating
+ * _start[], _nested[] or isr_depth, and its ticks would be counted twice
+ * or lost, or two handlers would end up on the same level.
+ *
+ * The interrupt entry and register saving before ISR_ENTER(), as well as
+ * the return after ISR_EXIT(), are not measured. Neither is the call into
+ * isr_stats_enter() itself, so an empty handler reports a few dozen ticks.
+ */
+
+#include <isr_stats.h>
+#include <critical.h>
+
+// Only built if ISR_STATS is defined, SDCC does not drop unused functions
+#ifdef ISR_STATS
+
+volatile isr_stat_t isr_stats[ISR_STATS_VECTORS];
+volatile uint8_t isr_depth;
+volatile uint8_t isr_max_depth;
+
+static volatile uint16_t _start[ISR_STATS_DEPTH];	// TIM2 count at entry, per nesting level
+static volatile uint16_t _nested[ISR_STATS_DEPTH];	// Ticks spent in nested handlers, per level
+
+static uint16_t tim2_count(void)
+{
+	uint8_t msb = TIM2->CNTRH; // Latches the LSB, only called with interrupts masked
+
+	return ((uint16_t)msb << 8) | TIM2->CNTRL;
+}
+
+void isr_stats_init(void)
+{
+	TIM2->PSCR = 0;			// Count at fCPU
+	TIM2->CR1 |= TIM2_CR1_CEN;	// Free-running up to 0xFFFF
+}
+
+void isr_stats_reset(void)
+{
+	uint8_t i;
+	critical_t cc = critical_enter();
+
+	for (i = 0; i < ISR_STATS_VECTORS; i++) {
+		isr_stats[i].count = 0;
+		isr_stats[i].max = 0;
+		isr_stats[i].total = 0;
+	}
+	isr_max_depth = 0;
+	critical_exit(cc);
+}
+
+void isr_stats_enter(void)
+{
+	critical_t cc = critical_enter();
+	uint8_t level = isr_depth++;
+
+	if (isr_depth > isr_max_depth)
+		isr_max_depth = isr_depth;
+
+	if (level < ISR_STATS_DEPTH) {
+		_nested[level] = 0;
+		_start[level] = tim2_count();
+	}
+
+	critical_exit(cc);
+}
+
+void isr_stats_exit(uint8_t vector)
+{
+	critical_t cc = critical_enter();
+	uint16_t now = tim2_count();
+	uint8_t level = isr_depth - 1;
+	volatile isr_stat_t *stat = &isr_stats[vector];
+	uint16_t ticks;
+
+	if (level < ISR_STATS_DEPTH) {
+		ticks = now - _start[level];	// Wraps correctly for runs shorter than 65536 ticks
+
+		if (level > 0)
+			_nested[level - 1] += ticks; // Not part of the interrupted handler
+
+		ticks -= _nested[level];
+
+		stat->count++;
+		stat->total += ticks;
+		if (ticks > stat->max)
+			stat->max = ticks;
+	}
+
+	isr_depth--;
+	critical_exit(cc);
+}
+
+#endif /* ISR_STATS */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the interrupt latency demonstration
+ *
+ * Both timers count at fCPU and restart at 0 on every update event, so the
+ * TIM2 counter read at the start of the tick handler is the number of
+ * cycles since the interrupt was requested. This includes the interrupt
+ * entry, in which the core saves its context in 9 cycles, the register
+ * saving of the handler and the call into itc_demo_tick_isr(), which are
+ * the same in both builds. Whatever exceeds them is time spent waiting
+ * for the slow handler.
+ */
+
+#include <itc_demo.h>
+
+// Only built if ITC_DEMO is defined, SDCC does not drop unused functions
+#ifdef ITC_DEMO
+
+volatile uint16_t itc_demo_ticks;
+volatile uint16_t itc_demo_latency;
+volatile uint16_t itc_demo_latency_max;
+
+void itc_demo_init(void)
+{
+	TIM1->PSCRH = 0;					// Count at fCPU
+	TIM1->PSCRL = 0;
+	TIM1->ARRH = (uint8_t)((ITC_DEMO_SLOW_PERIOD - 1) >> 8);
+	TIM1->ARRL = (uint8_t)(ITC_DEMO_SLOW_PERIOD - 1);
+	TIM1->IER |= TIM1_IER_UIE;
+	TIM1->CR1 |= TIM1_CR1_CEN;
+
+	TIM2->PSCR = 0;						// Count at fCPU
+	TIM2->ARRH = (uint8_t)((ITC_DEMO_TICK_CYCLES - 1) >> 8);
+	TIM2->ARRL = (uint8_t)(ITC_DEMO_TICK_CYCLES - 1);
+	TIM2->IER |= TIM2_IER_UIE;
+	TIM2->CR1 |= TIM2_CR1_CEN;
+}
+
+void itc_demo_tick_isr(void)
+{
+	uint16_t latency = (uint16_t)TIM2->CNTRH << 8;		// Reading the MSB latches the LSB
+	latency |= TIM2->CNTRL;
+
+	TIM2->SR1 = (uint8_t)(~TIM2_SR1_UIF);			// Clear update flag
+
+	itc_demo_latency = latency;
+	if (latency > itc_demo_latency_max)
+		itc_demo_latency_max = latency;
+	itc_demo_ticks++;
+}
+
+void itc_demo_slow_isr(void)
+{
+	uint16_t cnt;
+
+	TIM1->SR1 = (uint8_t)(~TIM1_SR1_UIF);			// Clear update flag
+
+	// Keep the core busy until TIM1 has counted ITC_DEMO_SLOW_CYCLES,
+	// which does not depend on the code the compiler generates
+	do {
+		cnt = (uint16_t)TIM1->CNTRH << 8;
+		cnt |= TIM1->CNTRL;
+	} while (cnt < ITC_DEMO_SLOW_CYCLES);
+}
+
+#endif /* ITC_DEMO */
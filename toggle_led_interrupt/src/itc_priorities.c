@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Interrupt priority table of the toggle_led_interrupt example
+ *
+ * The button handlers are the ones that may take their time: a human
+ * will not notice a few hundred microseconds. The end of the debounce
+ * lockout is placed above them, and the TIM2 tick of the latency
+ * demonstration (See itc_demo.c) above everything else.
+ */
+
+#include <itc_priorities.h>
+
+#if ITC_PRIORITIES
+static const itc_priority_t _priorities[] = {
+	{ ITC_IRQ_PORTD,    ITC_PRIORITYLEVEL_1 },	// Button edge (See debounce.c)
+	{ ITC_IRQ_AWU,      ITC_PRIORITYLEVEL_1 },	// Periodic wake up in active-halt
+	{ ITC_IRQ_TIM4_OVF, ITC_PRIORITYLEVEL_2 },	// End of the debounce lockout
+#ifdef ITC_DEMO
+	{ ITC_IRQ_TIM1_OVF, ITC_PRIORITYLEVEL_1 },	// Slow handler
+	{ ITC_IRQ_TIM2_OVF, ITC_PRIORITYLEVEL_3 },	// Fast tick
+#endif
+};
+#endif
+
+void itc_priorities_init(void)
+{
+#if ITC_PRIORITIES
+	uint8_t i;
+
+	for (i = 0; i < sizeof(_priorities) / sizeof(_priorities[0]); i++)
+		ITC_SetSoftwarePriority(_priorities[i].irq, _priorities[i].level);
+#endif
+}
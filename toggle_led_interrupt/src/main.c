@@ -16,28 +16,69 @@
  * 
  * Description: Main file for the toggle_led_interrupt example
  * 		The main function initializes the GPIO pins and interrupts
- * 		and then simply enters an infinite loop awaiting interrupts.
- * 		The interrupt handler is defined in the EXTI_PORTD_IRQHandler 
- * 		in the stm8s_it.c file, which toggles the LED.
+ * 		and then sleeps in an infinite loop awaiting interrupts.
+ * 		The interrupt handlers in the stm8s_it.c file debounce the
+ * 		button and post an event once it has been released, which
+ * 		the main loop then handles by toggling the LED.
  */
 
+#include <stddef.h>
+
 // PlatformIO
 #include <stm8s.h>
 
 // include/
 #include <stm8s_it.h>
 #include <pins.h>
+#include <gpio_fast.h>
+#include <power.h>
+#include <debounce.h>
+#include <isr_stats.h>
+#include <spurious.h>
+#include <itc_priorities.h>
+#include <itc_demo.h>
+#include <events.h>
+
+static void _button(const event_t *event)
+{
+	(void) event;
+	GPIO_TOGGLE(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Toggle LED
+}
+
+// Handler of each event code (See events.h), NULL to ignore the event
+static const event_handler_t _handlers[EVENT_CODES] = {
+	_button,	// EVENT_BUTTON
+	NULL,		// EVENT_WAKE: Nothing to do on a periodic wake up
+};
 
 // Main routine
 void main(void)
 {
-	GPIO_Init(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
-	GPIO_Init(BUTTON_PORT, BUTTON_PIN, GPIO_MODE_IN_PU_IT);			 // Push button: Pull-up, Interrupt enabled
+	SPURIOUS_INIT(); // Check the spurious interrupt log that survived the reset (See spurious.h)
+
+	GPIO_INIT(LED_BUILTIN_PORT, LED_BUILTIN_PIN, GPIO_MODE_OUT_PP_LOW_FAST); // Built-in LED: Output, Push Pull, Low level, 10MHz
+	GPIO_INIT(BUTTON_PORT, BUTTON_PIN, GPIO_MODE_IN_PU_IT);			 // Push button: Pull-up, Interrupt enabled
 
 	EXTI_SetExtIntSensitivity(EXTI_PORT_GPIOD, EXTI_SENSITIVITY_RISE_ONLY);	 // Set interrupt sensitivity of PORTD to rising edge (button released)
+	debounce_init();							 // Set up TIM4 as debounce lockout timer
+	power_init();								 // Set up the idle mode selected by IDLE_MODE (See power.h)
+	ISR_STATS_INIT();							 // Start the handler statistics, if enabled (See isr_stats.h)
+	itc_priorities_init();							 // Interrupt priorities, only writable while interrupts are disabled (See itc_priorities.h)
+	ITC_DEMO_INIT();							 // Start the latency demonstration, if enabled (See itc_demo.h)
+	events_init();								 // Start the event time stamps (See events.h)
 	enableInterrupts(); 							 // Enable interrupts
 
-	while(TRUE);
+	while(TRUE)
+	{
+		while (events_dispatch(_handlers))				 // Handle everything the interrupts have posted
+			;
+
+		disableInterrupts();						 // A post may not slip in between the check and sleep
+		if (events_pending())
+			enableInterrupts();
+		else
+			power_idle();						 // Sleep until the button wakes us up, re-enables interrupts
+	}
 }
 
 // See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
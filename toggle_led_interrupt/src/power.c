@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Implementation of the low power idle modes
+ *
+ * In halt and active-halt mode, the flash is powered down while the core
+ * sleeps, and in active-halt mode the main voltage regulator is switched
+ * off as well, leaving only the low power regulator, LSI and AWU running
+ * (See section 10 of the STM8S reference manual). This lengthens the wake
+ * up time by a few microseconds, which is of no concern for a push button.
+ *
+ * POWER_STATS counts with TIM2 at fCPU, which wraps every 65536 cycles,
+ * 32.8ms at 2MHz. Its update interrupt counts the wraps into the upper
+ * half of a 32-bit tick count, so longer awake periods are not lost. In
+ * halt, TIM2 stops along with the core and does not wake it. With wfi, a
+ * wrap wakes the core without POWER_WAKE(), which is neither counted as a
+ * wake up nor as awake time.
+ */
+
+#include <power.h>
+#include <critical.h>
+
+static volatile bool _keep_clocks;
+
+#ifdef POWER_STATS
+volatile uint16_t power_wakeups;
+volatile uint32_t power_awake_ticks;
+
+static volatile uint16_t _wraps;	// TIM2 overflows, upper half of the tick count
+static volatile uint32_t _wake_stamp;
+static volatile bool _awake;
+
+static uint16_t tim2_count(void)
+{
+	uint16_t cnt = (uint16_t)TIM2->CNTRH << 8; // Reading the MSB latches the LSB
+	return cnt | TIM2->CNTRL;
+}
+
+// Only called with interrupts masked, so power_tim2_isr() cannot count a
+// wrap in between. A wrap whose interrupt is still pending is added here.
+static uint32_t ticks(void)
+{
+	uint16_t wraps = _wraps;
+	uint16_t cnt = tim2_count();
+
+	if (TIM2->SR1 & TIM2_SR1_UIF) {
+		wraps++;
+		cnt = tim2_count(); // May have been read before the wrap
+	}
+
+	return ((uint32_t)wraps << 16) | cnt;
+}
+
+void power_wake(void)
+{
+	critical_t cc = critical_enter(); // The TIM2 handler may run at a higher level
+
+	if (!_awake) { // Else already awake, ex. nested or back-to-back interrupts
+		_wake_stamp = ticks();
+		_awake = TRUE;
+		power_wakeups++;
+	}
+
+	critical_exit(cc);
+}
+
+void power_tim2_isr(void)
+{
+	TIM2->SR1 = (uint8_t)(~TIM2_SR1_UIF); // Clear update flag
+	_wraps++;
+}
+#endif
+
+void power_init(void)
+{
+#if IDLE_MODE == IDLE_ACTIVE_HALT
+	// The flash powers down in halt with FLASH_CR1_HALT at its reset value
+	// of 0 (Setting it would keep the flash in standby instead), but stays
+	// operating in active-halt unless FLASH_CR1_AHALT is set
+	FLASH->CR1 |= FLASH_CR1_AHALT;	// Power down flash in active-halt
+	CLK->ICKR |= CLK_ICKR_REGAH;	// Switch main regulator off in active-halt
+	CLK->ICKR |= CLK_ICKR_LSIEN;	// AWU runs off the LSI
+	AWU_Init(AWU_TIMEBASE);		// Enables the AWU interrupt
+#endif
+
+#ifdef POWER_STATS
+	TIM2->PSCR = 0;			// Count at fCPU
+	TIM2->IER |= TIM2_IER_UIE;	// Count the wraps (See power_tim2_isr())
+	TIM2->CR1 |= TIM2_CR1_CEN;	// Free-running up to 0xFFFF, stops along with the core in halt
+	_awake = TRUE;			// Time until the first sleep counts as awake
+#endif
+}
+
+void power_keep_clocks(bool keep)
+{
+	_keep_clocks = keep;
+}
+
+void power_idle(void)
+{
+	disableInterrupts(); // An ISR may not slip in between the checks below and halt/wfi
+
+#ifdef POWER_STATS
+	if (_awake) // Not after a wake up by a TIM2 wrap alone
+		power_awake_ticks += ticks() - _wake_stamp;
+	_awake = FALSE;
+#endif
+
+	// Both instructions re-enable interrupts before stopping the core
+#if IDLE_MODE == IDLE_WFI
+	wfi();
+#else
+	if (_keep_clocks)
+		wfi();
+	else
+		halt(); // Active-halt, if the AWU is enabled
+#endif
+}
+
+void power_awu_isr(void)
+{
+	(void) AWU->CSR; // Reading AWU_CSR clears the AWUF flag
+}
@@ -31,7 +31,12 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stm8s_it.h>
-#include <pins.h>
+#include <power.h>
+#include <debounce.h>
+#include <isr_stats.h>
+#include <spurious.h>
+#include <itc_demo.h>
+#include <events.h>
 
 /** @addtogroup Template_Project
   * @{
@@ -68,9 +73,12 @@ INTERRUPT_HANDLER(NonHandledInterrupt, 25)
   */
 INTERRUPT_HANDLER_TRAP(TRAP_IRQHandler)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(SPURIOUS_TRAP);
+  ISR_EXIT(ISR_TRAP);
 }
 
 /**
@@ -81,9 +89,12 @@ INTERRUPT_HANDLER_TRAP(TRAP_IRQHandler)
 INTERRUPT_HANDLER(TLI_IRQHandler, 0)
 
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(0);
+  ISR_EXIT(0);
 }
 
 /**
@@ -93,9 +104,11 @@ INTERRUPT_HANDLER(TLI_IRQHandler, 0)
   */
 INTERRUPT_HANDLER(AWU_IRQHandler, 1)
 {
-  /* In order to detect unexpected events during development,
-     it is recommended to set a breakpoint on the following instruction.
-  */
+   ISR_ENTER();
+   POWER_WAKE();
+   power_awu_isr(); // Clear AWU flag
+   events_post(EVENT_SOURCE_AWU, EVENT_WAKE); // Handled by the main loop (See main.c)
+   ISR_EXIT(1);
 }
 
 /**
@@ -105,9 +118,12 @@ INTERRUPT_HANDLER(AWU_IRQHandler, 1)
   */
 INTERRUPT_HANDLER(CLK_IRQHandler, 2)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(2);
+  ISR_EXIT(2);
 }
 
 /**
@@ -117,9 +133,12 @@ INTERRUPT_HANDLER(CLK_IRQHandler, 2)
   */
 INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(3);
+  ISR_EXIT(3);
 }
 
 /**
@@ -129,9 +148,12 @@ INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
   */
 INTERRUPT_HANDLER(EXTI_PORTB_IRQHandler, 4)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(4);
+  ISR_EXIT(4);
 }
 
 /**
@@ -141,9 +163,12 @@ INTERRUPT_HANDLER(EXTI_PORTB_IRQHandler, 4)
   */
 INTERRUPT_HANDLER(EXTI_PORTC_IRQHandler, 5)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(5);
+  ISR_EXIT(5);
 }
 
 /**
@@ -153,11 +178,10 @@ INTERRUPT_HANDLER(EXTI_PORTC_IRQHandler, 5)
   */
 INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
 {
-   GPIO_WriteReverse(LED_BUILTIN_PORT, LED_BUILTIN_PIN); // Toggle LED
-   
-   // Note that we're not performing any debouncing here. If you're using a
-   // switch, you'll want to add some debouncing harware or add debouncing
-   // code here. For the sake of simplicity, we're not doing that here.
+   ISR_ENTER();
+   POWER_WAKE();
+   debounce_edge_isr(); // Mask further bounces and start the lockout timer
+   ISR_EXIT(6);
 }
 
 /**
@@ -167,9 +191,12 @@ INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
   */
 INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(7);
+  ISR_EXIT(7);
 }
 
 #if defined (STM8S903) || defined (STM8AF622x) 
@@ -180,9 +207,12 @@ INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
   */
  INTERRUPT_HANDLER(EXTI_PORTF_IRQHandler, 8)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(8);
+   ISR_EXIT(8);
  }
 #endif /* (STM8S903) || (STM8AF622x) */
 
@@ -194,9 +224,12 @@ INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
   */
  INTERRUPT_HANDLER(CAN_RX_IRQHandler, 8)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(8);
+   ISR_EXIT(8);
  }
 
 /**
@@ -206,9 +239,12 @@ INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
   */
  INTERRUPT_HANDLER(CAN_TX_IRQHandler, 9)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(9);
+   ISR_EXIT(9);
  }
 #endif /* (STM8S208) || (STM8AF52Ax) */
 
@@ -219,9 +255,12 @@ INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
   */
 INTERRUPT_HANDLER(SPI_IRQHandler, 10)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(10);
+  ISR_EXIT(10);
 }
 
 /**
@@ -231,9 +270,16 @@ INTERRUPT_HANDLER(SPI_IRQHandler, 10)
   */
 INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, 11)
 {
+  ISR_ENTER();
+#ifdef ITC_DEMO
+  itc_demo_slow_isr(); // Busy for ITC_DEMO_SLOW_CYCLES (See itc_demo.c)
+#else
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(11);
+#endif
+  ISR_EXIT(11);
 }
 
 /**
@@ -243,9 +289,12 @@ INTERRUPT_HANDLER(TIM1_UPD_OVF_TRG_BRK_IRQHandler, 11)
   */
 INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(12);
+  ISR_EXIT(12);
 }
 
 #if defined (STM8S903) || defined (STM8AF622x)
@@ -256,9 +305,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM5_UPD_OVF_BRK_TRG_IRQHandler, 13)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(13);
+   ISR_EXIT(13);
  }
  
 /**
@@ -268,9 +320,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM5_CAP_COM_IRQHandler, 14)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(14);
+   ISR_EXIT(14);
  }
 
 #else /* (STM8S208) || (STM8S207) || (STM8S105) || (STM8S103) || (STM8AF62Ax) || (STM8AF52Ax) || (STM8AF626x) */
@@ -281,9 +336,18 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM2_UPD_OVF_BRK_IRQHandler, 13)
  {
+   ISR_ENTER();
+#ifdef ITC_DEMO
+  itc_demo_tick_isr(); // Records its own latency (See itc_demo.c)
+#elif defined(POWER_STATS)
+  power_tim2_isr(); // Count TIM2 wraps into the awake time
+#else
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(13);
+#endif
+   ISR_EXIT(13);
  }
 
 /**
@@ -293,9 +357,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM2_CAP_COM_IRQHandler, 14)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(14);
+   ISR_EXIT(14);
  }
 #endif /* (STM8S903) || (STM8AF622x) */
 
@@ -308,9 +375,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM3_UPD_OVF_BRK_IRQHandler, 15)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(15);
+   ISR_EXIT(15);
  }
 
 /**
@@ -320,9 +390,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(TIM3_CAP_COM_IRQHandler, 16)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(16);
+   ISR_EXIT(16);
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8S105) || (STM8AF62Ax) || (STM8AF52Ax) || (STM8AF626x) */
 
@@ -335,9 +408,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART1_TX_IRQHandler, 17)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(17);
+   ISR_EXIT(17);
  }
 
 /**
@@ -347,9 +423,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART1_RX_IRQHandler, 18)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(18);
+   ISR_EXIT(18);
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8S103) || (STM8S903) || (STM8AF62Ax) || (STM8AF52Ax) */
 
@@ -361,9 +440,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART4_TX_IRQHandler, 17)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(17);
+   ISR_EXIT(17);
  }
 
 /**
@@ -373,9 +455,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART4_RX_IRQHandler, 18)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(18);
+   ISR_EXIT(18);
  }
 #endif /* (STM8AF622x) */
 
@@ -386,9 +471,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
 INTERRUPT_HANDLER(I2C_IRQHandler, 19)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(19);
+  ISR_EXIT(19);
 }
 
 #if defined(STM8S105) || defined(STM8S005) ||  defined (STM8AF626x)
@@ -399,9 +487,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(UART2_TX_IRQHandler, 20)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(20);
+   ISR_EXIT(20);
  }
 
 /**
@@ -411,9 +502,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(UART2_RX_IRQHandler, 21)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(21);
+   ISR_EXIT(21);
  }
 #endif /* (STM8S105) || (STM8AF626x) */
 
@@ -425,9 +519,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(UART3_TX_IRQHandler, 20)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(20);
+   ISR_EXIT(20);
  }
 
 /**
@@ -437,9 +534,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(UART3_RX_IRQHandler, 21)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(21);
+   ISR_EXIT(21);
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8AF52Ax) || (STM8AF62Ax) */
 
@@ -451,9 +551,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(ADC2_IRQHandler, 22)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(22);
+   ISR_EXIT(22);
  }
 #else /* STM8S105 or STM8S103 or STM8S903 or STM8AF626x or STM8AF622x */
 /**
@@ -465,9 +568,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
  INTERRUPT_HANDLER(ADC1_IRQHandler, 22)
  {
+   ISR_ENTER();
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+    SPURIOUS_ISR(22);
+   ISR_EXIT(22);
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8AF52Ax) || (STM8AF62Ax) */
 
@@ -479,9 +585,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   */
 INTERRUPT_HANDLER(TIM6_UPD_OVF_TRG_IRQHandler, 23)
  {
+   ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(23);
+   ISR_EXIT(23);
  }
 #else /* STM8S208 or STM8S207 or STM8S105 or STM8S103 or STM8AF52Ax or STM8AF62Ax or STM8AF626x */
 /**
@@ -491,9 +600,13 @@ INTERRUPT_HANDLER(TIM6_UPD_OVF_TRG_IRQHandler, 23)
   */
  INTERRUPT_HANDLER(TIM4_UPD_OVF_IRQHandler, 23)
  {
-  /* In order to detect unexpected events during development,
-     it is recommended to set a breakpoint on the following instruction.
-  */
+  ISR_ENTER();
+  POWER_WAKE();
+
+  if (debounce_timer_isr()) // Lockout over, button still released
+    events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON); // LED is toggled by the main loop (See main.c)
+
+  ISR_EXIT(23);
  }
 #endif /* (STM8S903) || (STM8AF622x)*/
 
@@ -504,9 +617,12 @@ INTERRUPT_HANDLER(TIM6_UPD_OVF_TRG_IRQHandler, 23)
   */
 INTERRUPT_HANDLER(EEPROM_EEC_IRQHandler, 24)
 {
+  ISR_ENTER();
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+  SPURIOUS_ISR(24);
+  ISR_EXIT(24);
 }
 
 /**
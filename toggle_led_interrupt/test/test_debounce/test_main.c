@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Description: Replays bouncing button waveforms against the firmware
+ * 		on the host build (See ../../../host/README.md) and checks
+ * 		that each press is reported exactly once.
+ *
+ * 		Run with: pio test -e native
+ */
+
+#include <stm8s.h>
+#include <setjmp.h>
+#include <unity.h>
+
+#include <pins.h>
+#include <events.h>
+#include <debounce.h>
+
+#undef main // build_flags apply to the test as well, only the firmware's main() is renamed
+
+#define US_TO_CYCLES(us) ((uint32_t)(us) * (F_CPU / 1000000UL))
+
+// Time after the last edge of a waveform, the lockout has ended by then
+#define SETTLE_US 20000UL
+
+// Button level after the given time since the previous edge
+typedef struct {
+	uint32_t us;
+	bool high;
+} edge_t;
+
+// Press and release of a tactile switch, held for 150ms. The waveforms are
+// synthetic, but shaped like the bounce of such switches: short bursts at
+// first and longer gaps towards the end, settling within two milliseconds.
+static const edge_t _press_release[] = {
+	{      0, FALSE }, {  30, TRUE }, {  25, FALSE }, {  60, TRUE }, {  40, FALSE },
+	{    150, TRUE  }, {  90, FALSE }, { 400, TRUE }, { 200, FALSE },
+	{ 150000, TRUE  }, {  20, FALSE }, {  35, TRUE }, {  80, FALSE }, { 120, TRUE },
+	{    300, FALSE }, { 250, TRUE  }, { 700, FALSE }, {  60, TRUE },
+};
+
+// Press that closes cleanly and only bounces on release, so the first
+// lockout after reset starts on a bounce
+static const edge_t _release_bounce[] = {
+	{      0, FALSE }, { 150000, TRUE }, {  20, FALSE }, {  35, TRUE }, {  80, FALSE },
+	{    120, TRUE  }, {    300, FALSE }, { 250, TRUE }, { 700, FALSE }, {  60, TRUE },
+};
+
+// Press that is still held when the test ends
+static const edge_t _press_held[] = {
+	{      0, FALSE }, {  40, TRUE }, {  35, FALSE }, { 120, TRUE }, { 300, FALSE },
+};
+
+// Clean release without bounces, to time the lockout
+static const edge_t _release_clean[] = {
+	{      0, FALSE }, { 50000, TRUE },
+};
+
+static jmp_buf _done;
+static const edge_t *_edges;
+static uint8_t _nedges;
+static uint8_t _repeat;
+static uint32_t _settle_us;
+static uint8_t _buttons;
+
+static void _count(const event_t *event)
+{
+	(void) event;
+	_buttons++;
+}
+
+static const event_handler_t _handlers[EVENT_CODES] = {
+	_count,	// EVENT_BUTTON
+	NULL,	// EVENT_WAKE
+};
+
+// Called by the first sleep of the main loop, once everything is set up
+static void _replay(bool halt)
+{
+	uint8_t r, i;
+
+	(void) halt;
+
+	for (r = 0; r < _repeat; r++) {
+		for (i = 0; i < _nedges; i++) {
+			host_tim4_run(US_TO_CYCLES(_edges[i].us));
+			host_gpio_input(BUTTON_PORT, BUTTON_PIN, _edges[i].high);
+		}
+		host_tim4_run(US_TO_CYCLES(_settle_us));
+
+		while (events_dispatch(_handlers)) // Like the main loop, before the queue fills up
+			;
+	}
+
+	longjmp(_done, 1);
+}
+
+static uint8_t _run(const edge_t *edges, uint8_t nedges, uint8_t repeat, uint32_t settle_us)
+{
+	_edges = edges;
+	_nedges = nedges;
+	_repeat = repeat;
+	_settle_us = settle_us;
+	_buttons = 0;
+
+	if (!setjmp(_done))
+		app_main();
+
+	return _buttons;
+}
+
+#define RUN(edges, repeat, settle_us) _run(edges, sizeof(edges) / sizeof(edges[0]), repeat, settle_us)
+
+void setUp(void)
+{
+	host_reset();
+	host_gpio_input(BUTTON_PORT, BUTTON_PIN, TRUE); // Pull-up, button released
+	host_idle_hook = _replay;
+}
+
+void tearDown(void)
+{
+}
+
+// The first lockout after reset must already last DEBOUNCE_MS, the
+// prescaler only takes effect with an update event
+static void test_first_press_after_reset(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(1, RUN(_release_bounce, 1, SETTLE_US));
+}
+
+static void test_press_and_release_bounce(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(1, RUN(_press_release, 1, SETTLE_US));
+}
+
+static void test_presses_in_a_row(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(5, RUN(_press_release, 5, SETTLE_US));
+}
+
+static void test_held_press_not_reported(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(0, RUN(_press_held, 1, SETTLE_US));
+}
+
+static void test_lockout_length(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(0, RUN(_release_clean, 1, DEBOUNCE_MS * 1000UL - 500));
+	setUp();
+	TEST_ASSERT_EQUAL_UINT8(1, RUN(_release_clean, 1, DEBOUNCE_MS * 1000UL + 500));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_first_press_after_reset);
+	RUN_TEST(test_press_and_release_bounce);
+	RUN_TEST(test_presses_in_a_row);
+	RUN_TEST(test_held_press_not_reported);
+	RUN_TEST(test_lockout_length);
+	return UNITY_END();
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Description: Checks the event queues (See ../../src/events.c) on the
+ * 		host build (See ../../../host/README.md): order, overflow
+ * 		and the dropped counters.
+ *
+ * 		Run with: pio test -e native
+ */
+
+#include <stm8s.h>
+#include <unity.h>
+
+#include <events.h>
+
+#undef main // build_flags apply to the test as well, only the firmware's main() is renamed
+
+#define MAX_SEEN 16
+
+static uint8_t _seen[MAX_SEEN];	// Codes in the order they were dispatched
+static uint8_t _nseen;
+
+static void _record(const event_t *event)
+{
+	if (_nseen < MAX_SEEN)
+		_seen[_nseen] = event->code;
+	_nseen++;
+}
+
+static const event_handler_t _handlers[EVENT_CODES] = {
+	_record,	// EVENT_BUTTON
+	_record,	// EVENT_WAKE
+};
+
+static uint8_t _drain(void)
+{
+	_nseen = 0;
+	while (events_dispatch(_handlers))
+		;
+
+	return _nseen;
+}
+
+void setUp(void)
+{
+	uint8_t i;
+
+	host_reset();
+	events_init();
+
+	// The queues are static, empty them of what the previous test left
+	_drain();
+	for (i = 0; i < EVENT_SOURCES; i++)
+		events_dropped[i] = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void test_empty(void)
+{
+	TEST_ASSERT_FALSE(events_pending());
+	TEST_ASSERT_FALSE(events_dispatch(_handlers));
+}
+
+static void test_fifo_order(void)
+{
+	events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+	events_post(EVENT_SOURCE_TIM4, EVENT_WAKE);
+	events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+
+	TEST_ASSERT_TRUE(events_pending());
+	TEST_ASSERT_EQUAL_UINT8(3, _drain());
+	TEST_ASSERT_EQUAL_UINT8(EVENT_BUTTON, _seen[0]);
+	TEST_ASSERT_EQUAL_UINT8(EVENT_WAKE, _seen[1]);
+	TEST_ASSERT_EQUAL_UINT8(EVENT_BUTTON, _seen[2]);
+	TEST_ASSERT_FALSE(events_pending());
+}
+
+// The lowest source goes first, whatever the order of posting
+static void test_source_order(void)
+{
+	events_post(EVENT_SOURCE_AWU, EVENT_WAKE);
+	events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+
+	TEST_ASSERT_EQUAL_UINT8(2, _drain());
+	TEST_ASSERT_EQUAL_UINT8(EVENT_BUTTON, _seen[0]);
+	TEST_ASSERT_EQUAL_UINT8(EVENT_WAKE, _seen[1]);
+}
+
+// A full queue keeps its events and counts the ones it had to drop
+static void test_overflow(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < EVENTS_QUEUE_SIZE; i++)
+		events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+	events_post(EVENT_SOURCE_TIM4, EVENT_WAKE);	// Dropped
+	events_post(EVENT_SOURCE_TIM4, EVENT_WAKE);	// Dropped
+
+	TEST_ASSERT_EQUAL_UINT8(2, events_dropped[EVENT_SOURCE_TIM4]);
+	TEST_ASSERT_EQUAL_UINT8(0, events_dropped[EVENT_SOURCE_AWU]);
+
+	TEST_ASSERT_EQUAL_UINT8(EVENTS_QUEUE_SIZE, _drain());
+	for (i = 0; i < EVENTS_QUEUE_SIZE; i++)
+		TEST_ASSERT_EQUAL_UINT8(EVENT_BUTTON, _seen[i]);
+
+	// Room again once dispatched
+	events_post(EVENT_SOURCE_TIM4, EVENT_WAKE);
+	TEST_ASSERT_EQUAL_UINT8(1, _drain());
+	TEST_ASSERT_EQUAL_UINT8(EVENT_WAKE, _seen[0]);
+	TEST_ASSERT_EQUAL_UINT8(2, events_dropped[EVENT_SOURCE_TIM4]);
+}
+
+// One full queue does not keep the other source from posting
+static void test_overflow_per_source(void)
+{
+	uint8_t i;
+
+	for (i = 0; i <= EVENTS_QUEUE_SIZE; i++)
+		events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+	events_post(EVENT_SOURCE_AWU, EVENT_WAKE);
+
+	TEST_ASSERT_EQUAL_UINT8(1, events_dropped[EVENT_SOURCE_TIM4]);
+	TEST_ASSERT_EQUAL_UINT8(0, events_dropped[EVENT_SOURCE_AWU]);
+	TEST_ASSERT_EQUAL_UINT8(EVENTS_QUEUE_SIZE + 1, _drain());
+	TEST_ASSERT_EQUAL_UINT8(EVENT_WAKE, _seen[EVENTS_QUEUE_SIZE]);
+}
+
+// The free-running indices wrap around the ring many times
+static void test_wrap_around(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < 300; i++) {
+		events_post(EVENT_SOURCE_TIM4, (uint8_t)(i & 1));
+		TEST_ASSERT_EQUAL_UINT8(1, _drain());
+		TEST_ASSERT_EQUAL_UINT8(i & 1, _seen[0]);
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(0, events_dropped[EVENT_SOURCE_TIM4]);
+}
+
+static void test_dropped_saturates(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < EVENTS_QUEUE_SIZE + 300; i++)
+		events_post(EVENT_SOURCE_AWU, EVENT_WAKE);
+
+	TEST_ASSERT_EQUAL_UINT8(0xFF, events_dropped[EVENT_SOURCE_AWU]);
+}
+
+// Codes without a handler are taken off the queue all the same
+static void test_no_handler(void)
+{
+	static const event_handler_t none[EVENT_CODES] = { NULL, NULL };
+
+	events_post(EVENT_SOURCE_TIM4, EVENT_BUTTON);
+	events_post(EVENT_SOURCE_TIM4, EVENT_CODES);	// Unknown code
+
+	TEST_ASSERT_TRUE(events_dispatch(none));
+	TEST_ASSERT_TRUE(events_dispatch(_handlers));
+	TEST_ASSERT_FALSE(events_dispatch(_handlers));
+	TEST_ASSERT_FALSE(events_pending());
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_empty);
+	RUN_TEST(test_fifo_order);
+	RUN_TEST(test_source_order);
+	RUN_TEST(test_overflow);
+	RUN_TEST(test_overflow_per_source);
+	RUN_TEST(test_wrap_around);
+	RUN_TEST(test_dropped_saturates);
+	RUN_TEST(test_no_handler);
+	return UNITY_END();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * Description: Checks the awake time POWER_STATS accumulates (See
+ * 		../../src/power.c) across TIM2 wraps on the host build
+ * 		(See ../../../host/README.md).
+ *
+ * 		Run with: pio test -e native_power
+ */
+
+#include <stm8s.h>
+#include <unity.h>
+
+#include <stm8s_it.h>
+#include <power.h>
+
+#ifndef POWER_STATS
+#error Build with -D POWER_STATS, see the native_power environment in platformio.ini
+#endif
+
+#undef main // build_flags apply to the test as well, only the firmware's main() is renamed
+
+static void _tim2_set(uint16_t cnt)
+{
+	TIM2->CNTRH = (uint8_t)(cnt >> 8);
+	TIM2->CNTRL = (uint8_t)cnt;
+}
+
+// TIM2 wraps to 0 and its update handler runs
+static void _tim2_wrap(void)
+{
+	TIM2->SR1 |= TIM2_SR1_UIF;
+	TIM2_UPD_OVF_BRK_IRQHandler();
+}
+
+void setUp(void)
+{
+	host_reset();
+	power_init();
+	power_idle();	// Ends the awake time since power_init()
+
+	power_wakeups = 0;
+	power_awake_ticks = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void test_init(void)
+{
+	TEST_ASSERT_TRUE(TIM2->IER & TIM2_IER_UIE);
+	TEST_ASSERT_TRUE(TIM2->CR1 & TIM2_CR1_CEN);
+}
+
+static void test_short(void)
+{
+	_tim2_set(1000);
+	power_wake();
+	_tim2_set(1500);
+	power_idle();
+
+	TEST_ASSERT_EQUAL_UINT16(1, power_wakeups);
+	TEST_ASSERT_EQUAL_UINT32(500, power_awake_ticks);
+}
+
+// Every wrap counts 65536 ticks, the awake time no longer wraps with TIM2
+static void test_wraps(void)
+{
+	_tim2_set(0xFFF0);
+	power_wake();
+	_tim2_wrap();
+	_tim2_wrap();
+	_tim2_set(0x0010);
+	power_idle();
+
+	TEST_ASSERT_EQUAL_UINT32(0x10 + 65536UL + 0x10, power_awake_ticks); // Up to the first wrap, a full turn, after the second
+	TEST_ASSERT_FALSE(TIM2->SR1 & TIM2_SR1_UIF);
+}
+
+// A wrap whose handler has not run yet, ex. with interrupts masked in
+// power_idle(), is counted all the same
+static void test_pending_wrap(void)
+{
+	_tim2_set(0xFFF0);
+	power_wake();
+	TIM2->SR1 |= TIM2_SR1_UIF;
+	_tim2_set(0x0005);
+	power_idle();
+
+	TEST_ASSERT_EQUAL_UINT32(0x10 + 5, power_awake_ticks);
+}
+
+// Only the first handler after a wake up takes the stamp
+static void test_nested_wake(void)
+{
+	_tim2_set(100);
+	power_wake();
+	_tim2_set(200);
+	power_wake();
+	_tim2_set(300);
+	power_idle();
+
+	TEST_ASSERT_EQUAL_UINT16(1, power_wakeups);
+	TEST_ASSERT_EQUAL_UINT32(200, power_awake_ticks);
+}
+
+// A wrap that wakes the core from wfi is neither a wake up nor awake time
+static void test_wake_by_wrap(void)
+{
+	_tim2_set(0xFFFF);
+	_tim2_wrap();
+	_tim2_set(50);
+	power_idle();
+
+	TEST_ASSERT_EQUAL_UINT16(0, power_wakeups);
+	TEST_ASSERT_EQUAL_UINT32(0, power_awake_ticks);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_init);
+	RUN_TEST(test_short);
+	RUN_TEST(test_wraps);
+	RUN_TEST(test_pending_wrap);
+	RUN_TEST(test_nested_wake);
+	RUN_TEST(test_wake_by_wrap);
+	return UNITY_END();
+}